@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeferredWorkSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static FAutoConsoleCommandWithWorld GFroggyWorkStatsCommand(
+	TEXT("Froggy.Work.Stats"),
+	TEXT("Prints the deferred work queue depth, how many jobs ran and how often the frame budget was overrun."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UDeferredWorkSubsystem* DeferredWork = World ? World->GetSubsystem<UDeferredWorkSubsystem>() : nullptr)
+		{
+			const FDeferredWorkStats Stats = DeferredWork->GetStats();
+			UE_LOG(LogTemp, Display, TEXT("🐸 Deferred work: %d queued (peak %d), %d run, %d skipped, %d overrun frames, %d backlog frames, %.3f ms last frame"),
+				Stats.QueueDepth, Stats.PeakQueueDepth, Stats.NumExecuted, Stats.NumSkipped, Stats.NumOverruns, Stats.NumBacklogFrames, Stats.LastFrameMs);
+		}
+	}));
+
+bool UDeferredWorkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDeferredWorkSubsystem::Deinitialize()
+{
+	// The world is going away - the objects these jobs are for are going with it.
+	Queue.Empty();
+	Stats.QueueDepth = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UDeferredWorkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDeferredWorkSubsystem, STATGROUP_Tickables);
+}
+
+void UDeferredWorkSubsystem::Enqueue(const UObject* Owner, TUniqueFunction<void()>&& Work)
+{
+	Queue.EmplaceLast(FDeferredJob{ Owner, MoveTemp(Work) });
+
+	Stats.QueueDepth = Queue.Num();
+	Stats.PeakQueueDepth = FMath::Max(Stats.PeakQueueDepth, Stats.QueueDepth);
+}
+
+void UDeferredWorkSubsystem::EnqueueOrRun(UWorld* World, const UObject* Owner, TUniqueFunction<void()>&& Work)
+{
+	if (UDeferredWorkSubsystem* DeferredWork = World ? World->GetSubsystem<UDeferredWorkSubsystem>() : nullptr)
+	{
+		DeferredWork->Enqueue(Owner, MoveTemp(Work));
+	}
+	else
+	{
+		Work();
+	}
+}
+
+void UDeferredWorkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Queue.IsEmpty())
+	{
+		Stats.LastFrameMs = 0.0f;
+		return;
+	}
+
+	const uint64 BudgetCycles = uint64(FrameBudgetMs / 1000.0 / FPlatformTime::GetSecondsPerCycle64());
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// Always at least one job, so a tiny budget can't stall the queue forever.
+	do
+	{
+		RunNextJob();
+	}
+	while (!Queue.IsEmpty() && FPlatformTime::Cycles64() - StartCycles < BudgetCycles);
+
+	const uint64 UsedCycles = FPlatformTime::Cycles64() - StartCycles;
+	Stats.LastFrameMs = float(FPlatformTime::ToMilliseconds64(UsedCycles));
+	Stats.QueueDepth = Queue.Num();
+
+	if (UsedCycles > BudgetCycles)
+	{
+		++Stats.NumOverruns;
+	}
+	if (!Queue.IsEmpty())
+	{
+		++Stats.NumBacklogFrames;
+	}
+}
+
+void UDeferredWorkSubsystem::Flush()
+{
+	while (!Queue.IsEmpty())
+	{
+		RunNextJob();
+	}
+	Stats.QueueDepth = 0;
+}
+
+void UDeferredWorkSubsystem::RunNextJob()
+{
+	// Move the job out first - it may well queue new work while it runs.
+	FDeferredJob Job = MoveTemp(Queue.First());
+	Queue.PopFirst();
+
+	if (IsValid(Job.Owner.Get()))
+	{
+		Job.Work();
+		++Stats.NumExecuted;
+	}
+	else
+	{
+		++Stats.NumSkipped;
+	}
+}
@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyAnimInstance.h"
+#include "FroggyCharacter.h"
+#include "FroggyStats.h"
+#include "Animation/AnimSequenceBase.h"
+#include "AnimationRuntime.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+bool FFroggyAnimInstanceProxy::Evaluate(FPoseContext& Output)
+{
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_AnimWorker);
+
+	// Nothing loaded yet - let the engine output the ref pose.
+	if (!CurrentSequence) return false;
+
+	FAnimationPoseData OutputData(Output);
+
+	if (BlendAlpha >= 1.0f || !PreviousSequence)
+	{
+		CurrentSequence->GetAnimationPose(OutputData, FAnimExtractContext(double(CurrentTime)));
+		return true;
+	}
+
+	// Still fading out of the last state: sample both and mix them.
+	FPoseContext CurrentPose(Output);
+	FAnimationPoseData CurrentData(CurrentPose);
+	CurrentSequence->GetAnimationPose(CurrentData, FAnimExtractContext(double(CurrentTime)));
+
+	FPoseContext PreviousPose(Output);
+	FAnimationPoseData PreviousData(PreviousPose);
+	PreviousSequence->GetAnimationPose(PreviousData, FAnimExtractContext(double(PreviousTime)));
+
+	FAnimationRuntime::BlendTwoPosesTogether(CurrentData, PreviousData, BlendAlpha, OutputData);
+	return true;
+}
+
+UFroggyAnimInstance::UFroggyAnimInstance()
+{
+	// Only paths here, nothing loads until NativeInitializeAnimation.
+	IdleAnimation = TSoftObjectPtr<UAnimSequenceBase>(FSoftObjectPath(TEXT("/Game/Froggy_Blender/FroggyRigFinal_Anim_Idle_Anim.FroggyRigFinal_Anim_Idle_Anim")));
+	WalkAnimation = TSoftObjectPtr<UAnimSequenceBase>(FSoftObjectPath(TEXT("/Game/Froggy_Blender/FroggyRigFinal_Anim_Walk_Anim.FroggyRigFinal_Anim_Walk_Anim")));
+	SitAnimation = TSoftObjectPtr<UAnimSequenceBase>(FSoftObjectPath(TEXT("/Game/Froggy_Blender/FroggyRigFinal_Anim_Sit_Anim.FroggyRigFinal_Anim_Sit_Anim")));
+	OpenDoorAnimation = TSoftObjectPtr<UAnimSequenceBase>(FSoftObjectPath(TEXT("/Game/Froggy_Blender/FroggyRigFinal_Anim_Opening_Door_Anim.FroggyRigFinal_Anim_Opening_Door_Anim")));
+}
+
+FAnimInstanceProxy* UFroggyAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FFroggyAnimInstanceProxy(this);
+}
+
+void UFroggyAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete static_cast<FFroggyAnimInstanceProxy*>(InProxy);
+}
+
+void UFroggyAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	Froggy = Cast<AFroggyCharacter>(TryGetPawnOwner());
+	if (Froggy)
+	{
+		LastLongInteractCount = Froggy->GetLongInteractCount();
+	}
+
+	// Without an asset manager (some editor previews), we just use whatever is already in memory.
+	TArray<FSoftObjectPath> Paths = { IdleAnimation.ToSoftObjectPath(), WalkAnimation.ToSoftObjectPath(),
+		SitAnimation.ToSoftObjectPath(), OpenDoorAnimation.ToSoftObjectPath() };
+	Paths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+
+	if (Paths.Num() > 0 && UAssetManager::IsInitialized())
+	{
+		AnimationsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &UFroggyAnimInstance::OnAnimationsLoaded));
+	}
+	else
+	{
+		OnAnimationsLoaded();
+	}
+}
+
+void UFroggyAnimInstance::NativeUninitializeAnimation()
+{
+	if (AnimationsHandle.IsValid())
+	{
+		AnimationsHandle->CancelHandle();
+		AnimationsHandle.Reset();
+	}
+
+	Super::NativeUninitializeAnimation();
+}
+
+void UFroggyAnimInstance::OnAnimationsLoaded()
+{
+	// Indexed by EFroggyAnimState. Runs on the game thread, outside of the animation update.
+	LoadedSequences[uint8(EFroggyAnimState::Idle)] = IdleAnimation.Get();
+	LoadedSequences[uint8(EFroggyAnimState::Walk)] = WalkAnimation.Get();
+	LoadedSequences[uint8(EFroggyAnimState::Sit)] = SitAnimation.Get();
+	LoadedSequences[uint8(EFroggyAnimState::OpenDoor)] = OpenDoorAnimation.Get();
+}
+
+void UFroggyAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_AnimGameThread);
+
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	// The only game thread work: copy what we need off the character. Everything else is in the thread-safe update.
+	if (!Froggy) return;
+
+	Inputs.Velocity = Froggy->GetVelocity();
+	Inputs.bIsSitting = Froggy->GetIsSitting();
+	Inputs.bIsFalling = Froggy->GetCharacterMovement() && Froggy->GetCharacterMovement()->IsFalling();
+	Inputs.LongInteractCount = Froggy->GetLongInteractCount();
+}
+
+void UFroggyAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_AnimWorker);
+
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	Speed = Inputs.Velocity.Size2D();
+	bIsSitting = Inputs.bIsSitting;
+
+	// A new long interact starts the door animation; it plays out once (ChooseState keeps us in it until then).
+	if (Inputs.LongInteractCount != LastLongInteractCount)
+	{
+		LastLongInteractCount = Inputs.LongInteractCount;
+		bIsOpeningDoor = true;
+
+		// Already opening a door? Start it over.
+		if (State == EFroggyAnimState::OpenDoor)
+		{
+			StateTime = 0.0f;
+		}
+	}
+
+	const EFroggyAnimState NewState = ChooseState();
+	if (NewState != State)
+	{
+		PreviousState = State;
+		PreviousStateTime = StateTime;
+		State = NewState;
+		StateTime = 0.0f;
+		BlendElapsed = 0.0f;
+	}
+
+	// The walk speeds up/slows down with Froggy, so the feet don't slide. A forced walk has no Froggy to follow.
+	const float PlayRate = State == EFroggyAnimState::Walk && !bHasForcedState && WalkAnimationSpeed > 0.0f ? Speed / WalkAnimationSpeed : 1.0f;
+	const UAnimSequenceBase* Sequence = GetSequence(State);
+	const UAnimSequenceBase* PreviousSequence = GetSequence(PreviousState);
+
+	StateTime = AdvanceTime(Sequence, StateTime, DeltaSeconds * PlayRate, IsLooping(State));
+	BlendElapsed += DeltaSeconds;
+	const float BlendAlpha = BlendTime > 0.0f ? FMath::Clamp(BlendElapsed / BlendTime, 0.0f, 1.0f) : 1.0f;
+	if (BlendAlpha < 1.0f)
+	{
+		PreviousStateTime = AdvanceTime(PreviousSequence, PreviousStateTime, DeltaSeconds, IsLooping(PreviousState));
+	}
+
+	// Done with the door once the animation has played through.
+	if (State == EFroggyAnimState::OpenDoor && Sequence && StateTime >= Sequence->GetPlayLength())
+	{
+		bIsOpeningDoor = false;
+	}
+
+	FFroggyAnimInstanceProxy& Proxy = GetProxyOnAnyThread<FFroggyAnimInstanceProxy>();
+	Proxy.CurrentSequence = Sequence;
+	Proxy.PreviousSequence = BlendAlpha < 1.0f ? PreviousSequence : nullptr;
+	Proxy.CurrentTime = StateTime;
+	Proxy.PreviousTime = PreviousStateTime;
+	Proxy.BlendAlpha = BlendAlpha;
+}
+
+EFroggyAnimState UFroggyAnimInstance::ChooseState() const
+{
+	if (bHasForcedState) return ForcedState;
+
+	// Sitting wins over everything, then the door, then moving around.
+	if (bIsSitting) return EFroggyAnimState::Sit;
+	if (bIsOpeningDoor) return EFroggyAnimState::OpenDoor;
+
+	// No jump/fall animation yet - a falling Froggy keeps whatever it was doing instead of snapping to idle.
+	if (Inputs.bIsFalling) return State == EFroggyAnimState::OpenDoor || State == EFroggyAnimState::Sit ? EFroggyAnimState::Idle : State;
+
+	const float Threshold = State == EFroggyAnimState::Walk ? WalkStopSpeed : WalkStartSpeed;
+	return Speed > Threshold ? EFroggyAnimState::Walk : EFroggyAnimState::Idle;
+}
+
+const UAnimSequenceBase* UFroggyAnimInstance::GetSequence(EFroggyAnimState ForState) const
+{
+	return LoadedSequences[uint8(ForState)];
+}
+
+float UFroggyAnimInstance::AdvanceTime(const UAnimSequenceBase* Sequence, float Time, float DeltaSeconds, bool bLooping)
+{
+	const float Length = Sequence ? Sequence->GetPlayLength() : 0.0f;
+	if (Length <= 0.0f) return 0.0f;
+
+	const float NewTime = Time + DeltaSeconds;
+	return bLooping ? FMath::Fmod(NewTime, Length) : FMath::Min(NewTime, Length);
+}
@@ -0,0 +1,745 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+/**
+ * Headless benchmark for the interaction / pickup paths.
+ *
+ * Spawns N AInteractableItems into a fresh, empty world, walks an AFroggyCharacter through them and times
+ * CheckForNearbyItems, Interact, PickupAnItem and item spawning (fresh and from the pool), plus the memory the items
+ * take and how long a full GC pass takes with them around. Everything random comes from a fixed seed, so two runs
+ * on the same build do the same work. Results are written as JSON to Saved/Profiling/FroggyBench/.
+ *
+ * Item memory is counted, not sampled from the process: the UObject size (plus what its arrays etc. allocated) of the
+ * items and everything inside them, and what the spatial hash holds for them.
+ *
+ * The same runs are automation tests ("Froggy.Bench.*"), which also fail if the run didn't do the work it should
+ * have (e.g. items that never made it into the spatial hash). Run them headless on Linux like this:
+ *   UnrealEditor-Cmd BenjaminComp2Prog1.uproject -game -nullrhi -unattended -nosound
+ *     -ExecCmds="Automation RunTests Froggy.Bench; Quit"
+ * or just the console command, with your own counts and seed:
+ *     -ExecCmds="Froggy.Bench.Run 1000,10000,100000 1337; Quit"
+ *
+ * Froggy.Bench.QueryModes compares the three Froggy.Interaction.QueryMode settings (spatial hash, sync physics,
+ * async physics) on a dense item field, ticking the world so async results actually arrive. It reports game thread
+ * time per step: the query calls themselves, and the world tick (where async results are picked up). The spatial
+ * hash and sync physics have to pick up the same items and have a focus target on the same steps, or the run fails.
+ *
+ * Froggy.Bench.Inventory times UFroggyInventoryComponent on its own (no world needed): adding new stacks, adding to
+ * existing ones, area pickup sized AddItems batches, count lookups and removing every stack, in ns per operation,
+ * plus the memory the full inventory holds.
+ *
+ * Not compiled into Shipping builds.
+ */
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "FroggyCharacter.h"
+#include "FroggyCrowdSubsystem.h"
+#include "FroggyInventoryComponent.h"
+#include "InteractableItem.h"
+#include "ItemPoolSubsystem.h"
+#include "DeferredWorkSubsystem.h"
+#include "InteractionFocusComponent.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectHash.h"
+
+// Results and failures only. The gameplay code under test keeps logging to LogTemp as usual.
+DEFINE_LOG_CATEGORY_STATIC(LogFroggyBench, Log, All);
+
+namespace FroggyBench
+{
+	// Average distance between items, so every run has about the same item density around Froggy.
+	static constexpr float ItemSpacing = 300.0f;
+
+	// How many spots Froggy visits, and how far apart they are.
+	static constexpr int32 NumWalkSteps = 2000;
+	static constexpr float WalkStepLength = 100.0f;
+
+	// How many items get picked up / re-spawned on their own, for the per-call timings.
+	static constexpr int32 MaxPickupSamples = 1000;
+
+	// How many items are measured for the memory numbers. They're all the same, so more would only take longer.
+	static constexpr int32 MaxMemorySamples = 1000;
+
+	/** Timings of one sample set, in microseconds. */
+	struct FTimingSummary
+	{
+		int32 Count = 0;
+		double MeanUs = 0.0;
+		double MedianUs = 0.0;
+		double P95Us = 0.0;
+		double MaxUs = 0.0;
+
+		static FTimingSummary FromSamples(TArray<double>& SamplesUs)
+		{
+			FTimingSummary Summary;
+			Summary.Count = SamplesUs.Num();
+			if (SamplesUs.Num() == 0) return Summary;
+
+			SamplesUs.Sort();
+			double Total = 0.0;
+			for (const double Sample : SamplesUs)
+			{
+				Total += Sample;
+			}
+
+			Summary.MeanUs = Total / SamplesUs.Num();
+			Summary.MedianUs = SamplesUs[SamplesUs.Num() / 2];
+			Summary.P95Us = SamplesUs[FMath::Min(SamplesUs.Num() - 1, FMath::FloorToInt32(SamplesUs.Num() * 0.95))];
+			Summary.MaxUs = SamplesUs.Last();
+			return Summary;
+		}
+
+		FString ToJson() const
+		{
+			return FString::Printf(TEXT("{ \"count\": %d, \"mean_us\": %.3f, \"median_us\": %.3f, \"p95_us\": %.3f, \"max_us\": %.3f }"),
+				Count, MeanUs, MedianUs, P95Us, MaxUs);
+		}
+	};
+
+	struct FRunResult
+	{
+		int32 NumItems = 0;
+		double SpawnMs = 0.0;           // Spawning all N items (pool misses = real spawns)
+		int64 ItemBytesPerItem = 0;     // UObject memory of one item and everything inside it
+		int64 SpatialHashBytes = 0;     // What the spatial hash holds with all N items in it
+		FTimingSummary Query;           // CheckForNearbyItems (including the immediate part of any pickups it triggers)
+		FTimingSummary Interact;        // AFroggyCharacter::Interact
+		FTimingSummary Pickup;          // PickupAnItem on a single pickup (the part that happens right away)
+		FTimingSummary PickupDeferred;  // The deferred part of a single pickup (message, back to the pool)
+		FTimingSummary PooledSpawn;     // AcquireItem when the pool has a sleeping item
+		int32 WalkPickups = 0;          // Items picked up while walking
+		double WalkDeferredMs = 0.0;    // Running all the work the walk deferred
+		double GCMs = 0.0;              // A full GC pass with all the items alive
+		FString Error;                  // Set if the run didn't measure what it should have - the numbers are useless then
+
+		FString ToJson() const
+		{
+			return FString::Printf(
+				TEXT("{ \"items\": %d, \"error\": \"%s\", \"spawn_ms\": %.3f, \"spawn_us_per_item\": %.3f, \"item_bytes_per_item\": %lld, ")
+				TEXT("\"item_bytes\": %lld, \"spatial_hash_bytes\": %lld, \"query\": %s, \"interact\": %s, \"pickup\": %s, \"pickup_deferred\": %s, ")
+				TEXT("\"pooled_spawn\": %s, \"walk_pickups\": %d, \"walk_deferred_ms\": %.3f, \"gc_ms\": %.3f }"),
+				NumItems, *Error, SpawnMs, NumItems > 0 ? SpawnMs * 1000.0 / NumItems : 0.0, ItemBytesPerItem,
+				ItemBytesPerItem * NumItems, SpatialHashBytes, *Query.ToJson(), *Interact.ToJson(),
+				*Pickup.ToJson(), *PickupDeferred.ToJson(), *PooledSpawn.ToJson(), WalkPickups, WalkDeferredMs, GCMs);
+		}
+	};
+
+	/** A bare game world that isn't the one the player is in. Cleaned up when it goes out of scope. */
+	struct FScopedBenchWorld
+	{
+		UWorld* World = nullptr;
+
+		FScopedBenchWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("FroggyBenchWorld"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+
+			// There's no game mode here (and none is needed), but without one nothing would ever call BeginPlay on
+			// the actors - so the items would never register with the spatial hash. Do what the game mode's
+			// StartPlay would: from here on, every spawned actor gets BeginPlay.
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+
+		~FScopedBenchWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+	};
+
+	static double ToMicroseconds(uint64 StartCycles)
+	{
+		return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+	}
+
+	/** The object's size, plus whatever its arrays/maps/strings allocated. (Serialize counts the object's own size too.) */
+	static int64 CountObjectBytes(const UObject* Object)
+	{
+		FArchiveCountMem CountMem(const_cast<UObject*>(Object));
+		return CountMem.GetMax();
+	}
+
+	/** An actor and everything inside it (components, ...). */
+	static int64 CountActorBytes(const AActor* Actor)
+	{
+		int64 Bytes = CountObjectBytes(Actor);
+
+		TArray<UObject*> Inner;
+		GetObjectsWithOuter(Actor, Inner, true);
+		for (const UObject* Object : Inner)
+		{
+			Bytes += CountObjectBytes(Object);
+		}
+		return Bytes;
+	}
+
+	/** Spawns the bench Froggy. Only the bench drives it: no pickup timer, no crowd, no focus tick. */
+	static AFroggyCharacter* SpawnBenchFroggy(UWorld* World)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AFroggyCharacter* Froggy = World->SpawnActor<AFroggyCharacter>(AFroggyCharacter::StaticClass(), FTransform::Identity, SpawnParams);
+
+		if (UFroggyCrowdSubsystem* Crowd = World->GetSubsystem<UFroggyCrowdSubsystem>())
+		{
+			Crowd->UnregisterFroggy(Froggy);
+		}
+		Froggy->SetPickupChecksEnabled(false);
+		Froggy->GetInteractionFocus()->SetComponentTickEnabled(false);
+		return Froggy;
+	}
+
+	static FRunResult RunOnce(int32 NumItems, int32 Seed)
+	{
+		FRunResult Result;
+		Result.NumItems = NumItems;
+
+		FScopedBenchWorld BenchWorld;
+		UWorld* World = BenchWorld.World;
+		UItemPoolSubsystem* Pool = World->GetSubsystem<UItemPoolSubsystem>();
+		UDeferredWorkSubsystem* DeferredWork = World->GetSubsystem<UDeferredWorkSubsystem>();
+		FRandomStream Random(Seed);
+
+		// Square field, sized so the density is the same no matter how many items there are.
+		const float HalfExtent = FMath::Sqrt(float(NumItems)) * ItemSpacing * 0.5f;
+
+		// 1. Spawning
+		const uint64 SpawnStart = FPlatformTime::Cycles64();
+
+		TArray<AInteractableItem*> PickupItems;
+		for (int32 Index = 0; Index < NumItems; ++Index)
+		{
+			const FVector Location(Random.FRandRange(-HalfExtent, HalfExtent), Random.FRandRange(-HalfExtent, HalfExtent), 0.0f);
+			AInteractableItem* Item = Pool->AcquireItem(AInteractableItem::StaticClass(), FTransform(Location));
+
+			// A quarter of the items are pickups, the rest toggle their light when interacted with.
+			Item->bIsAPickup = (Index % 4 == 0);
+			Item->bToggleLight = !Item->bIsAPickup;
+			if (Item->bIsAPickup)
+			{
+				PickupItems.Add(Item);
+			}
+		}
+
+		Result.SpawnMs = ToMicroseconds(SpawnStart) / 1000.0;
+
+		// Everything below queries the hash - if the items aren't in it, all we'd time is empty queries.
+		const UItemSpatialHashSubsystem* ItemIndex = World->GetSubsystem<UItemSpatialHashSubsystem>();
+		if (!ItemIndex || ItemIndex->GetNumItems() != NumItems)
+		{
+			Result.Error = FString::Printf(TEXT("spawned %d items, but %d are in the spatial hash"), NumItems, ItemIndex ? ItemIndex->GetNumItems() : 0);
+			return Result;
+		}
+
+		// Memory, counted on a sample of the items (they're all the same) plus the hash they're in.
+		const int32 NumMemorySamples = FMath::Min(MaxMemorySamples, PickupItems.Num());
+		int64 SampledBytes = 0;
+		for (int32 Sample = 0; Sample < NumMemorySamples; ++Sample)
+		{
+			SampledBytes += CountActorBytes(PickupItems[Sample]);
+		}
+		Result.ItemBytesPerItem = NumMemorySamples > 0 ? SampledBytes / NumMemorySamples : 0;
+		Result.SpatialHashBytes = ItemIndex->GetAllocatedSize();
+
+		// 2. GC with everything alive - the mark phase has to visit every item and component.
+		const uint64 GCStart = FPlatformTime::Cycles64();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		Result.GCMs = ToMicroseconds(GCStart) / 1000.0;
+
+		// 3. Walk Froggy through the field, checking for pickups and interacting at every step.
+		AFroggyCharacter* Froggy = SpawnBenchFroggy(World);
+
+		const FItemPoolStats StatsBeforeWalk = Pool->GetStats();
+		TArray<double> QuerySamples;
+		TArray<double> InteractSamples;
+		QuerySamples.Reserve(NumWalkSteps);
+		InteractSamples.Reserve(NumWalkSteps);
+
+		FVector FroggyLocation = FVector::ZeroVector;
+		for (int32 Step = 0; Step < NumWalkSteps; ++Step)
+		{
+			const FVector Direction = FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+			FroggyLocation = (FroggyLocation + Direction * WalkStepLength).BoundToBox(FVector(-HalfExtent, -HalfExtent, 0.0f), FVector(HalfExtent, HalfExtent, 0.0f));
+			Froggy->SetActorLocation(FroggyLocation, false, nullptr, ETeleportType::TeleportPhysics);
+
+			const uint64 QueryStart = FPlatformTime::Cycles64();
+			Froggy->CheckForNearbyItems();
+			QuerySamples.Add(ToMicroseconds(QueryStart));
+
+			const uint64 InteractStart = FPlatformTime::Cycles64();
+			Froggy->Interact();
+			InteractSamples.Add(ToMicroseconds(InteractStart));
+		}
+
+		// The world doesn't tick here, so run what the walk queued up in one go.
+		const uint64 WalkFlushStart = FPlatformTime::Cycles64();
+		DeferredWork->Flush();
+		Result.WalkDeferredMs = ToMicroseconds(WalkFlushStart) / 1000.0;
+
+		Result.WalkPickups = Pool->GetStats().Releases - StatsBeforeWalk.Releases;
+		Result.Query = FTimingSummary::FromSamples(QuerySamples);
+		Result.Interact = FTimingSummary::FromSamples(InteractSamples);
+
+		// A quarter of the items are pickups and Froggy walks 200 m through them - finding none means a broken run.
+		if (Result.WalkPickups == 0)
+		{
+			Result.Error = TEXT("the walk didn't pick up a single item");
+			return Result;
+		}
+
+		// 4. Single pickups, on pickup items the walk didn't reach.
+		PickupItems.RemoveAll([](const AInteractableItem* Item) { return Item->IsPooled(); });
+		const int32 NumPickupSamples = FMath::Min(MaxPickupSamples, PickupItems.Num());
+
+		TArray<double> PickupSamples;
+		TArray<double> PickupDeferredSamples;
+		for (int32 Sample = 0; Sample < NumPickupSamples; ++Sample)
+		{
+			AInteractableItem* Item = PickupItems[Random.RandHelper(PickupItems.Num())];
+			PickupItems.RemoveSwap(Item);
+
+			const uint64 PickupStart = FPlatformTime::Cycles64();
+			Froggy->PickupAnItem(Item);
+			PickupSamples.Add(ToMicroseconds(PickupStart));
+
+			const uint64 FlushStart = FPlatformTime::Cycles64();
+			DeferredWork->Flush();
+			PickupDeferredSamples.Add(ToMicroseconds(FlushStart));
+		}
+		Result.Pickup = FTimingSummary::FromSamples(PickupSamples);
+		Result.PickupDeferred = FTimingSummary::FromSamples(PickupDeferredSamples);
+
+		// 5. Spawning again, now that the pool has sleeping items to hand out.
+		TArray<double> PooledSpawnSamples;
+		for (int32 Sample = 0; Sample < NumPickupSamples; ++Sample)
+		{
+			const FVector Location(Random.FRandRange(-HalfExtent, HalfExtent), Random.FRandRange(-HalfExtent, HalfExtent), 0.0f);
+
+			const uint64 AcquireStart = FPlatformTime::Cycles64();
+			Pool->AcquireItem(AInteractableItem::StaticClass(), FTransform(Location));
+			PooledSpawnSamples.Add(ToMicroseconds(AcquireStart));
+		}
+		Result.PooledSpawn = FTimingSummary::FromSamples(PooledSpawnSamples);
+
+		return Result;
+	}
+
+	static void SaveResults(const TCHAR* BenchmarkName, int32 Seed, const TArray<FString>& RunJson)
+	{
+		const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+		const FString Json = FString::Printf(
+			TEXT("{\n  \"benchmark\": \"%s\",\n  \"build\": \"%s\",\n  \"changelist\": %d,\n  \"config\": \"%s\",\n  \"seed\": %d,\n  \"timestamp\": \"%s\",\n  \"runs\": [\n    %s\n  ]\n}\n"),
+			BenchmarkName, FApp::GetBuildVersion(), FEngineVersion::Current().GetChangelist(), LexToString(FApp::GetBuildConfiguration()),
+			Seed, *Timestamp, *FString::Join(RunJson, TEXT(",\n    ")));
+
+		const FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Profiling/FroggyBench") / FString::Printf(TEXT("%s-%s.json"), BenchmarkName, *Timestamp);
+		if (FFileHelper::SaveStringToFile(Json, *OutputPath))
+		{
+			UE_LOG(LogFroggyBench, Display, TEXT("🐸 %s results written to %s"), BenchmarkName, *OutputPath);
+		}
+		else
+		{
+			UE_LOG(LogFroggyBench, Error, TEXT("❌ %s could not write %s"), BenchmarkName, *OutputPath);
+		}
+	}
+
+	// Query mode comparison: items packed tightly, so every query has plenty of candidates.
+	static constexpr float DenseItemSpacing = 60.0f;
+	static constexpr int32 NumQueryModeSteps = 300;
+	static constexpr float QueryModeDeltaTime = 1.0f / 60.0f;
+
+	struct FQueryModeResult
+	{
+		int32 Pickups = 0;      // Items picked up over the whole walk
+		int32 FocusHits = 0;    // Steps where the focus had a target
+		FString Json;
+		FString Error;          // Set if the run didn't measure what it should have
+	};
+
+	static FQueryModeResult RunQueryMode(int32 NumItems, int32 Seed, int32 Mode)
+	{
+		FQueryModeResult Result;
+
+		IConsoleVariable* QueryModeVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Froggy.Interaction.QueryMode"));
+		const int32 OldMode = QueryModeVar->GetInt();
+		QueryModeVar->Set(Mode, ECVF_SetByCode);
+
+		FScopedBenchWorld BenchWorld;
+		UWorld* World = BenchWorld.World;
+		UItemPoolSubsystem* Pool = World->GetSubsystem<UItemPoolSubsystem>();
+		FRandomStream Random(Seed);
+
+		const float HalfExtent = FMath::Sqrt(float(NumItems)) * DenseItemSpacing * 0.5f;
+		for (int32 Index = 0; Index < NumItems; ++Index)
+		{
+			const FVector Location(Random.FRandRange(-HalfExtent, HalfExtent), Random.FRandRange(-HalfExtent, HalfExtent), 0.0f);
+			AInteractableItem* Item = Pool->AcquireItem(AInteractableItem::StaticClass(), FTransform(Location));
+			Item->bIsAPickup = (Index % 4 == 0);
+		}
+
+		const UItemSpatialHashSubsystem* ItemIndex = World->GetSubsystem<UItemSpatialHashSubsystem>();
+		if (!ItemIndex || ItemIndex->GetNumItems() != NumItems)
+		{
+			QueryModeVar->Set(OldMode, ECVF_SetByCode);
+			Result.Error = FString::Printf(TEXT("spawned %d items, but %d are in the spatial hash"), NumItems, ItemIndex ? ItemIndex->GetNumItems() : 0);
+			return Result;
+		}
+
+		AFroggyCharacter* Froggy = SpawnBenchFroggy(World);
+		UInteractionFocusComponent* Focus = Froggy->GetInteractionFocus();
+
+		const FItemPoolStats StatsBefore = Pool->GetStats();
+		TArray<double> CallSamples;
+		TArray<double> TickSamples;
+
+		FVector FroggyLocation = FVector::ZeroVector;
+		for (int32 Step = 0; Step < NumQueryModeSteps; ++Step)
+		{
+			const FVector Direction = FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+			FroggyLocation = (FroggyLocation + Direction * WalkStepLength).BoundToBox(FVector(-HalfExtent, -HalfExtent, 0.0f), FVector(HalfExtent, HalfExtent, 0.0f));
+			Froggy->SetActorLocation(FroggyLocation, false, nullptr, ETeleportType::TeleportPhysics);
+
+			// What gameplay code pays directly: issuing (or running) the pickup query and the focus query.
+			const uint64 CallStart = FPlatformTime::Cycles64();
+			Froggy->CheckForNearbyItems();
+			const bool bHasTarget = Focus->SelectBestTarget() != nullptr;
+			CallSamples.Add(ToMicroseconds(CallStart));
+
+			// Async mode answers a frame late, so this counts what the previous step found - same total in the end.
+			Result.FocusHits += bHasTarget ? 1 : 0;
+
+			// The rest of the frame - async results are delivered (and waited on, if not done) in here.
+			const uint64 TickStart = FPlatformTime::Cycles64();
+			World->Tick(LEVELTICK_All, QueryModeDeltaTime);
+			TickSamples.Add(ToMicroseconds(TickStart));
+		}
+
+		// One more frame, so the last async answers come in before we count pickups.
+		World->Tick(LEVELTICK_All, QueryModeDeltaTime);
+		World->GetSubsystem<UDeferredWorkSubsystem>()->Flush();
+
+		QueryModeVar->Set(OldMode, ECVF_SetByCode);
+
+		const FTimingSummary Calls = FTimingSummary::FromSamples(CallSamples);
+		const FTimingSummary Ticks = FTimingSummary::FromSamples(TickSamples);
+		Result.Pickups = Pool->GetStats().Releases - StatsBefore.Releases;
+
+		if (Result.Pickups == 0)
+		{
+			Result.Error = TEXT("the walk didn't pick up a single item");
+		}
+
+		UE_LOG(LogFroggyBench, Display, TEXT("🐸 FroggyBench query mode %d, %d items: calls %.2f us (p95 %.2f), world tick %.2f us, %d pickups, %d focus hits"),
+			Mode, NumItems, Calls.MeanUs, Calls.P95Us, Ticks.MeanUs, Result.Pickups, Result.FocusHits);
+
+		static const TCHAR* ModeNames[] = { TEXT("spatial_hash"), TEXT("sync_physics"), TEXT("async_physics") };
+		Result.Json = FString::Printf(TEXT("{ \"mode\": \"%s\", \"items\": %d, \"error\": \"%s\", \"calls\": %s, \"world_tick\": %s, \"game_thread_us_per_step\": %.3f, \"pickups\": %d, \"focus_hits\": %d }"),
+			ModeNames[Mode], NumItems, *Result.Error, *Calls.ToJson(), *Ticks.ToJson(), Calls.MeanUs + Ticks.MeanUs, Result.Pickups, Result.FocusHits);
+		return Result;
+	}
+
+	/**
+	 * Runs all three modes. Returns what went wrong, or an empty string: a run that failed, or the spatial hash and
+	 * sync physics disagreeing on what's there - then the timing comparison is between two different amounts of work.
+	 */
+	static FString RunQueryModes(int32 NumItems, int32 Seed)
+	{
+		TArray<FQueryModeResult> Results;
+		for (int32 Mode = 0; Mode <= 2; ++Mode)
+		{
+			Results.Add(RunQueryMode(NumItems, Seed, Mode));
+		}
+
+		FString Error;
+		for (int32 Mode = 0; Mode < Results.Num() && Error.IsEmpty(); ++Mode)
+		{
+			if (!Results[Mode].Error.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("query mode %d: %s"), Mode, *Results[Mode].Error);
+			}
+		}
+		if (Error.IsEmpty() && (Results[0].Pickups != Results[1].Pickups || Results[0].FocusHits != Results[1].FocusHits))
+		{
+			Error = FString::Printf(TEXT("spatial hash and sync physics found different items: %d vs %d pickups, %d vs %d focus hits"),
+				Results[0].Pickups, Results[1].Pickups, Results[0].FocusHits, Results[1].FocusHits);
+		}
+
+		TArray<FString> RunJson;
+		for (const FQueryModeResult& Result : Results)
+		{
+			RunJson.Add(Result.Json.IsEmpty() ? FString::Printf(TEXT("{ \"error\": \"%s\" }"), *Result.Error) : Result.Json);
+		}
+		RunJson.Add(FString::Printf(TEXT("{ \"parity\": %s, \"error\": \"%s\" }"), Error.IsEmpty() ? TEXT("true") : TEXT("false"), *Error));
+		SaveResults(TEXT("FroggyBenchQueryModes"), Seed, RunJson);
+
+		return Error;
+	}
+
+	static void RunQueryModesCommand(const TArray<FString>& Args)
+	{
+		// Args: [item count] [seed]
+		const int32 NumItems = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+		const int32 Seed = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1337;
+
+		const FString Error = RunQueryModes(NumItems, Seed);
+		if (!Error.IsEmpty())
+		{
+			UE_LOG(LogFroggyBench, Error, TEXT("❌ FroggyBench query modes: %s - the comparison means nothing"), *Error);
+		}
+	}
+
+	// Inventory: an area pickup's worth of items per AddItems call.
+	static constexpr int32 InventoryBatchSize = 32;
+
+	static double ToNanosecondsPerOp(uint64 StartCycles, int32 NumOps)
+	{
+		return NumOps > 0 ? ToMicroseconds(StartCycles) * 1000.0 / NumOps : 0.0;
+	}
+
+	static FString RunInventory(int32 NumEntries, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+
+		// Ids and the random orders are made up front, so only the inventory itself is timed.
+		TArray<FName> Ids;
+		TArray<FName> RandomIds;
+		Ids.Reserve(NumEntries);
+		RandomIds.Reserve(NumEntries);
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			Ids.Add(FName(*FString::Printf(TEXT("BenchItem_%d"), Index)));
+		}
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			RandomIds.Add(Ids[Random.RandHelper(NumEntries)]);
+		}
+		TArray<FName> RemoveOrder = Ids;
+		for (int32 Index = RemoveOrder.Num() - 1; Index > 0; --Index)
+		{
+			RemoveOrder.Swap(Index, Random.RandRange(0, Index));
+		}
+
+		// No owner, so it counts as the server and doesn't replicate anything.
+		UFroggyInventoryComponent* Inventory = NewObject<UFroggyInventoryComponent>(GetTransientPackage());
+
+		// 1. A new stack for every id
+		const uint64 AddNewStart = FPlatformTime::Cycles64();
+		for (const FName Id : Ids)
+		{
+			Inventory->AddItem(Id);
+		}
+		const double AddNewNs = ToNanosecondsPerOp(AddNewStart, NumEntries);
+
+		// 2. Onto stacks that are already there
+		const uint64 AddExistingStart = FPlatformTime::Cycles64();
+		for (const FName Id : RandomIds)
+		{
+			Inventory->AddItem(Id);
+		}
+		const double AddExistingNs = ToNanosecondsPerOp(AddExistingStart, NumEntries);
+
+		// 3. Area pickups
+		const uint64 BulkAddStart = FPlatformTime::Cycles64();
+		for (int32 Index = 0; Index + InventoryBatchSize <= NumEntries; Index += InventoryBatchSize)
+		{
+			Inventory->AddItems(TConstArrayView<FName>(RandomIds.GetData() + Index, InventoryBatchSize));
+		}
+		const double BulkAddNs = ToNanosecondsPerOp(BulkAddStart, NumEntries / InventoryBatchSize * InventoryBatchSize);
+
+		// 4. Lookups (summed, so the compiler can't drop them)
+		int64 CountSum = 0;
+		const uint64 QueryStart = FPlatformTime::Cycles64();
+		for (const FName Id : RandomIds)
+		{
+			CountSum += Inventory->GetCount(Id);
+		}
+		const double QueryNs = ToNanosecondsPerOp(QueryStart, NumEntries);
+
+		const int32 NumStacks = Inventory->GetNumStacks();
+		const int32 TotalCount = Inventory->GetTotalCount();
+		const int64 Bytes = Inventory->GetAllocatedSize();
+
+		// 5. Every stack, in random order - the swap-remove path
+		const uint64 RemoveStart = FPlatformTime::Cycles64();
+		for (const FName Id : RemoveOrder)
+		{
+			Inventory->RemoveItem(Id, MAX_int32);
+		}
+		const double RemoveNs = ToNanosecondsPerOp(RemoveStart, NumEntries);
+
+		const bool bEmpty = Inventory->GetNumStacks() == 0 && Inventory->GetTotalCount() == 0;
+		Inventory->MarkAsGarbage();
+
+		UE_LOG(LogFroggyBench, Display, TEXT("🐸 FroggyBench inventory %d entries: add new %.1f ns, add existing %.1f ns, bulk add %.1f ns, query %.1f ns, remove %.1f ns, %lld bytes (%.1f per stack)%s"),
+			NumEntries, AddNewNs, AddExistingNs, BulkAddNs, QueryNs, RemoveNs, Bytes, NumStacks > 0 ? double(Bytes) / NumStacks : 0.0,
+			bEmpty ? TEXT("") : TEXT(" - ❌ not empty after removing everything!"));
+
+		return FString::Printf(
+			TEXT("{ \"entries\": %d, \"stacks\": %d, \"total_count\": %d, \"count_sum\": %lld, \"add_new_ns\": %.2f, \"add_existing_ns\": %.2f, ")
+			TEXT("\"bulk_add_ns\": %.2f, \"bulk_batch_size\": %d, \"query_ns\": %.2f, \"remove_ns\": %.2f, \"query_mops\": %.2f, ")
+			TEXT("\"allocated_bytes\": %lld, \"bytes_per_stack\": %.1f, \"empty_after_remove\": %s }"),
+			NumEntries, NumStacks, TotalCount, CountSum, AddNewNs, AddExistingNs, BulkAddNs, InventoryBatchSize, QueryNs, RemoveNs,
+			QueryNs > 0.0 ? 1000.0 / QueryNs : 0.0, Bytes, NumStacks > 0 ? double(Bytes) / NumStacks : 0.0, bEmpty ? TEXT("true") : TEXT("false"));
+	}
+
+	static void RunInventoryBench(const TArray<FString>& Args)
+	{
+		// Args: [comma separated entry counts] [seed]
+		TArray<int32> EntryCounts = { 10000, 100000 };
+		int32 Seed = 1337;
+
+		if (Args.Num() > 0)
+		{
+			TArray<FString> CountStrings;
+			Args[0].ParseIntoArray(CountStrings, TEXT(","));
+			EntryCounts.Reset();
+			for (const FString& CountString : CountStrings)
+			{
+				EntryCounts.Add(FMath::Max(1, FCString::Atoi(*CountString)));
+			}
+		}
+		if (Args.Num() > 1)
+		{
+			Seed = FCString::Atoi(*Args[1]);
+		}
+
+		TArray<FString> RunJson;
+		for (const int32 NumEntries : EntryCounts)
+		{
+			RunJson.Add(RunInventory(NumEntries, Seed));
+		}
+
+		SaveResults(TEXT("FroggyBenchInventory"), Seed, RunJson);
+	}
+
+	static void Run(const TArray<FString>& Args)
+	{
+		// Args: [comma separated item counts] [seed]
+		TArray<int32> ItemCounts = { 1000, 10000, 100000 };
+		int32 Seed = 1337;
+
+		if (Args.Num() > 0)
+		{
+			TArray<FString> CountStrings;
+			Args[0].ParseIntoArray(CountStrings, TEXT(","));
+			ItemCounts.Reset();
+			for (const FString& CountString : CountStrings)
+			{
+				ItemCounts.Add(FMath::Max(1, FCString::Atoi(*CountString)));
+			}
+		}
+		if (Args.Num() > 1)
+		{
+			Seed = FCString::Atoi(*Args[1]);
+		}
+
+		TArray<FString> RunJson;
+		for (const int32 NumItems : ItemCounts)
+		{
+			const FRunResult Result = RunOnce(NumItems, Seed);
+			RunJson.Add(Result.ToJson());
+
+			if (!Result.Error.IsEmpty())
+			{
+				UE_LOG(LogFroggyBench, Error, TEXT("❌ FroggyBench %d items: %s - the timings of this run mean nothing"), NumItems, *Result.Error);
+				continue;
+			}
+
+			UE_LOG(LogFroggyBench, Display, TEXT("🐸 FroggyBench %d items: spawn %.2f ms, query %.2f us (p95 %.2f), interact %.2f us, pickup %.2f us, GC %.2f ms"),
+				NumItems, Result.SpawnMs, Result.Query.MeanUs, Result.Query.P95Us, Result.Interact.MeanUs, Result.Pickup.MeanUs, Result.GCMs);
+		}
+
+		SaveResults(TEXT("FroggyBench"), Seed, RunJson);
+	}
+}
+
+static FAutoConsoleCommand GFroggyBenchCommand(
+	TEXT("Froggy.Bench.Run"),
+	TEXT("Benchmarks item spawning, CheckForNearbyItems, Interact and pickups in a generated world. ")
+	TEXT("Usage: Froggy.Bench.Run [Counts=1000,10000,100000] [Seed=1337]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FroggyBench::Run));
+
+static FAutoConsoleCommand GFroggyBenchQueryModesCommand(
+	TEXT("Froggy.Bench.QueryModes"),
+	TEXT("Compares game thread time of the spatial hash, sync physics and async physics interaction queries on a dense item field. ")
+	TEXT("Usage: Froggy.Bench.QueryModes [Count=10000] [Seed=1337]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FroggyBench::RunQueryModesCommand));
+
+static FAutoConsoleCommand GFroggyBenchInventoryCommand(
+	TEXT("Froggy.Bench.Inventory"),
+	TEXT("Benchmarks adding, removing and looking up items in a Froggy inventory with N different items. ")
+	TEXT("Usage: Froggy.Bench.Inventory [Counts=10000,100000] [Seed=1337]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FroggyBench::RunInventoryBench));
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Automation versions of the benchmarks. Not part of the smoke tests (a 100k item world takes a while), run them on purpose:
+//   Automation RunTests Froggy.Bench
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FFroggyBenchInteractionTest, "Froggy.Bench.Interaction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FFroggyBenchInteractionTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 NumItems : { 1000, 10000, 100000 })
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%d items"), NumItems));
+		OutTestCommands.Add(FString::FromInt(NumItems));
+	}
+}
+
+bool FFroggyBenchInteractionTest::RunTest(const FString& Parameters)
+{
+	const int32 NumItems = FCString::Atoi(*Parameters);
+	const int32 Seed = 1337;
+
+	const FroggyBench::FRunResult Result = FroggyBench::RunOnce(NumItems, Seed);
+
+	if (!TestTrue(FString::Printf(TEXT("Run did the work it should have (%s)"), *Result.Error), Result.Error.IsEmpty()))
+	{
+		return false;
+	}
+	TestTrue(TEXT("Every spawn was timed"), Result.SpawnMs > 0.0);
+	TestTrue(TEXT("Item memory was counted"), Result.ItemBytesPerItem > 0 && Result.SpatialHashBytes > 0);
+
+	AddInfo(FString::Printf(TEXT("spawn %.2f ms, query %.2f us (p95 %.2f), interact %.2f us, pickup %.2f us, GC %.2f ms, %lld bytes per item"),
+		Result.SpawnMs, Result.Query.MeanUs, Result.Query.P95Us, Result.Interact.MeanUs, Result.Pickup.MeanUs, Result.GCMs, Result.ItemBytesPerItem));
+
+	FroggyBench::SaveResults(*FString::Printf(TEXT("FroggyBench-%d"), NumItems), Seed, { Result.ToJson() });
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFroggyBenchQueryModesTest, "Froggy.Bench.QueryModes",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FFroggyBenchQueryModesTest::RunTest(const FString& Parameters)
+{
+	const FString Error = FroggyBench::RunQueryModes(10000, 1337);
+	return TestTrue(FString::Printf(TEXT("All query modes ran and found the same items (%s)"), *Error), Error.IsEmpty());
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
+
+#endif // !UE_BUILD_SHIPPING
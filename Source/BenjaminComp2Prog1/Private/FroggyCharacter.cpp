@@ -5,6 +5,8 @@
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/Controller.h"
@@ -12,7 +14,48 @@
 #include "InputActionValue.h"
 #include "InputMappingContext.h"
 #include "InteractableItem.h"
+#include "InteractionFocusComponent.h"
+#include "FroggyAnimInstance.h"
+#include "FroggyCrowdSubsystem.h"
+#include "FroggyInventoryComponent.h"
+#include "FroggyMovementComponent.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "InteractionQuery.h"
+#include "FroggyStats.h"
+#include "FroggyTelemetrySubsystem.h"
 #include "ProtagonistController.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+// Flip to 1 to load the input assets the old blocking way - handy to compare the possess-time stall before/after.
+static TAutoConsoleVariable<bool> CVarFroggySyncLoadInputAssets(
+	TEXT("Froggy.Input.SyncLoad"),
+	false,
+	TEXT("If true, Froggy loads its input assets synchronously on the game thread instead of as an async bundle."));
+
+static TAutoConsoleVariable<bool> CVarFroggyPredict(
+	TEXT("Froggy.Net.Predict"),
+	true,
+	TEXT("Clients apply their own interactions/pickups right away and roll back if the server says no. ")
+	TEXT("Off = send the request and wait for the server's answer."));
+
+static FAutoConsoleCommandWithWorld GFroggyPredictionStatsCommand(
+	TEXT("Froggy.Net.PredictionStats"),
+	TEXT("Logs predicted interactions/pickups, mispredictions and round trips for the local Froggy."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TActorIterator<AFroggyCharacter> It(World); It; ++It)
+		{
+			if (It->IsLocallyControlled())
+			{
+				It->LogPredictionStats();
+			}
+		}
+	}));
 
 /**
 	* Overview and Execution Order of the code:
@@ -27,7 +70,9 @@
  */
 
 // Sets default values, initializing the values for better, robust code.
-AFroggyCharacter::AFroggyCharacter()
+// The ObjectInitializer is how a subclass swaps out a component its parent creates - here ACharacter's movement.
+AFroggyCharacter::AFroggyCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UFroggyMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = false;
@@ -56,6 +101,26 @@ AFroggyCharacter::AFroggyCharacter()
 	PickupSphere->SetupAttachment(RootComponent);
 	PickupSphere->InitSphereRadius(PickupRadius);
 
+	// Create the focus component, which picks the item Interact() acts on
+	InteractionFocus = CreateDefaultSubobject<UInteractionFocusComponent>(TEXT("InteractionFocus"));
+
+	// Create the inventory, where picked up items go
+	Inventory = CreateDefaultSubobject<UFroggyInventoryComponent>(TEXT("Inventory"));
+
+	// Idle/walk/sit/door animations are all native, mostly on worker threads (see UFroggyAnimInstance)
+	GetMesh()->SetAnimInstanceClass(UFroggyAnimInstance::StaticClass());
+
+	// Update Rate Optimizations: Froggies that are small on screen update their animation less often (and interpolate).
+	// Our own Froggy is always big on screen, so this is mostly for the crowd.
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+
+	// Soft references to the input assets. Only the paths are stored here, nothing is loaded until RequestInputAssets.
+	IMC_Player = TSoftObjectPtr<UInputMappingContext>(FSoftObjectPath(TEXT("/Game/Input/IMC_Player.IMC_Player")));
+	IA_Move = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/Input/IA_Move.IA_Move")));
+	IA_Sit = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/Input/IA_Sit.IA_Sit")));
+	IA_Interact = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/Input/IA_Interact.IA_Interact")));
+	IA_Look = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/Input/IA_Look.IA_Look")));
+
 	// Just to test and practice logging:
 	// Being mindful that floats have to be limited due too many decimal spaces: %.2f = 2 decimals, %.1f = 1 decimal.
 	// And strings need a * in front of them, otherwise no print for you.
@@ -76,21 +141,84 @@ AFroggyCharacter::AFroggyCharacter()
 void AFroggyCharacter::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// InteractRadius can be changed per Blueprint/instance, so hand it over here instead of in the constructor.
+	InteractionFocus->FocusRadius = InteractRadius;
 	
-	// Run timer for checking pickup items in given interval; and run the corresponding function CheckForNearbyPickups.
-	GetWorld()->GetTimerManager().SetTimer(PickupTimerHandle, this, &AFroggyCharacter::CheckForNearbyItems, PickupCheckTimeInterval, true);
+	// Start checking for pickup items. UpdatePickupCheck reschedules itself, faster or slower depending on Froggy's speed.
+	// Whoever controls Froggy does the checks (a client asks the server for each pickup, see PickupAnItem).
+	// Other players' Froggys are skipped in UpdatePickupCheck - who controls who can change after BeginPlay.
+	GetWorld()->GetTimerManager().SetTimer(PickupTimerHandle, this, &AFroggyCharacter::UpdatePickupCheck, PickupCheckTimeInterval, false);
+
+	UpdateCrowdMembership();
+}
+
+void AFroggyCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFroggyCrowdSubsystem* Crowd = GetWorld()->GetSubsystem<UFroggyCrowdSubsystem>())
+	{
+		Crowd->UnregisterFroggy(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UFroggyMovementComponent* AFroggyCharacter::GetFroggyMovement() const
+{
+	return Cast<UFroggyMovementComponent>(GetCharacterMovement());
+}
+
+void AFroggyCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_SkipOwner; // The owning client set it itself
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AFroggyCharacter, bIsSitting, Params);
 }
 
 void AFroggyCharacter::NotifyControllerChanged()
 {
 	Super::NotifyControllerChanged();
 
+	UpdateCrowdMembership();
+
 	// This nasty piece of log (sneaky conditional statement) actually finds the controller that triggers NotifyControllerChanged.
 	// If GetController returns a name, we print that name, else we print nothing.
 	UE_LOG(LogTemp, Warning, TEXT("🐸 NotifyControllerChanged Called! Controller: %s"), 
 	       (GetController() ? *GetController()->GetName() : TEXT("None")));
 }
 
+void AFroggyCharacter::OnRep_PlayerState()
+{
+	Super::OnRep_PlayerState();
+
+	// On clients, this is how we find out a Froggy belongs to another player and not the AI.
+	UpdateCrowdMembership();
+}
+
+void AFroggyCharacter::UpdateCrowdMembership()
+{
+	// Before BeginPlay, BeginPlay itself sorts it out.
+	if (!HasActorBegunPlay() && !IsActorBeginningPlay()) return;
+
+	UFroggyCrowdSubsystem* Crowd = GetWorld()->GetSubsystem<UFroggyCrowdSubsystem>();
+	if (!Crowd) return;
+
+	// A player's Froggy (ours, or somebody else's) always gets full detail.
+	const bool bIsPlayer = IsPlayerControlled() || (GetController() && GetController()->IsPlayerController());
+	if (bIsPlayer)
+	{
+		Crowd->UnregisterFroggy(this);
+	}
+	else
+	{
+		Crowd->RegisterFroggy(this);
+	}
+}
+
 void AFroggyCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
@@ -108,67 +236,98 @@ void AFroggyCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCom
 	}
 
 	/**
-	 *	Just want to highlight that the method of loading assets dynamically in runtime via BeginPlay() and StaticLoadObject,
-	 *	is different from the ConstructorHelper::FObjectFinder, which can only be done inside constructors:
+	 *	Just want to highlight that the input assets used to be loaded here with StaticLoadObject, which blocks the game
+	 *	thread until the files are read - five times in a row, right when the pawn gets possessed.
+	 *	That is different from the ConstructorHelper::FObjectFinder, which can only be done inside constructors:
 	 *
-	 *	Just leaving the example here for how you would do it in the constructor with ConstructorHelper.
-	 * 
 	 *  static ConstructorHelpers::FObjectFinder<UInputAction> IA_MoveFinder(TEXT("InputAction'/Game/Input/IA_Move.IA_Move'"));
 	 *  if (IA_MoveFinder.Succeeded()) { IA_Move = IA_MoveFinder.Object; }
-	 *  else
-	 *  {
-	 * 	 UE_LOG(LogTemp, Error, TEXT("Failed to load IA_Move!"));
-	 *  }
+	 *
+	 *	Now they're soft references (TSoftObjectPtr), which is just a path until something loads it. All five get
+	 *	requested together as one async bundle, and the ProtagonistController binds input once the bundle is done.
 	 */
-	
-	// Cast to EnhancedInputComponent and set-up action bindings, if not nullptr
-	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
+	if (!Cast<UEnhancedInputComponent>(PlayerInputComponent))
 	{
-		// If IMC_Player null, assign it the InputMappingContext in the described path.
-		if (!IMC_Player)
-		{
-			IMC_Player = Cast<UInputMappingContext>(StaticLoadObject(UInputMappingContext::StaticClass(), nullptr, TEXT("InputMappingContext'/Game/Input/IMC_Player.IMC_Player'")));
-			if (IMC_Player) { UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded InputMappingContext")); }
-			else { UE_LOG(LogTemp, Error, TEXT("❌ Failed to load InputMappingContext")); }
-		}
+		UE_LOG(LogTemp, Error, TEXT("EnhancedInputComponent not found!"))
+		return;
+	}
 
-		if (!IA_Move)
-		{
-			IA_Move = Cast<UInputAction>(StaticLoadObject(UInputAction::StaticClass(), nullptr, TEXT("InputAction'/Game/Input/IA_Move.IA_Move'")));
-			if (IA_Move) { UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded IA_Move")); }
-			else { UE_LOG(LogTemp, Error, TEXT("❌ Failed to load IA_Move!")); }
-		}
-	
-		if (!IA_Sit)
-		{
-			IA_Sit = Cast<UInputAction>(StaticLoadObject(UInputAction::StaticClass(), nullptr, TEXT("InputAction'/Game/Input/IA_Sit.IA_Sit'")));
-			if (IA_Sit) { UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded IA_Sit")); }
-			else { UE_LOG(LogTemp, Error, TEXT("❌ Failed to load IA_Sit!")); }
-		}
-	
-		if (!IA_Interact)
-		{
-			IA_Interact = Cast<UInputAction>(StaticLoadObject(UInputAction::StaticClass(), nullptr, TEXT("InputAction'/Game/Input/IA_Interact.IA_Interact'")));
-			if (IA_Interact) { UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded IA_Interact")); }
-			else { UE_LOG(LogTemp, Error, TEXT("❌ Failed to load IA_Interact!")); }
-		}
-	
-		if (!IA_Look)
-		{
-			IA_Look = Cast<UInputAction>(StaticLoadObject(UInputAction::StaticClass(), nullptr, TEXT("InputAction'/Game/Input/IA_Look.IA_Look'")));
-			if (IA_Look) { UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded IA_Look")); }
-			else { UE_LOG(LogTemp, Error, TEXT("❌ Failed to load IA_Look!")); }
-		}
+	RequestInputAssets();
+}
+
+bool AFroggyCharacter::AreInputAssetsLoaded() const
+{
+	return IMC_Player.IsValid() && IA_Move.IsValid() && IA_Sit.IsValid() && IA_Interact.IsValid() && IA_Look.IsValid();
+}
+
+void AFroggyCharacter::RequestInputAssets()
+{
+	// Already loading - the callback will bind the new input component too, once it fires.
+	if (InputAssetsHandle.IsValid() && InputAssetsHandle->IsLoadingInProgress())
+	{
+		return;
 	}
-	else
+
+	InputAssetsRequestTime = FPlatformTime::Seconds();
+
+	if (CVarFroggySyncLoadInputAssets.GetValueOnGameThread())
 	{
-		UE_LOG(LogTemp, Error, TEXT("EnhancedInputComponent not found!"))
+		// The old way, kept around for measuring: block until everything is loaded.
+		IMC_Player.LoadSynchronous();
+		IA_Move.LoadSynchronous();
+		IA_Sit.LoadSynchronous();
+		IA_Interact.LoadSynchronous();
+		IA_Look.LoadSynchronous();
+		OnInputAssetsLoaded();
+		return;
+	}
+
+	TArray<FSoftObjectPath> InputAssetPaths = {
+		IMC_Player.ToSoftObjectPath(),
+		IA_Move.ToSoftObjectPath(),
+		IA_Sit.ToSoftObjectPath(),
+		IA_Interact.ToSoftObjectPath(),
+		IA_Look.ToSoftObjectPath()
+	};
+
+	// If the assets are already in memory (e.g. a respawn), the streamable manager calls us back right away.
+	InputAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(InputAssetPaths),
+		FStreamableDelegate::CreateUObject(this, &AFroggyCharacter::OnInputAssetsLoaded),
+		FStreamableManager::AsyncLoadHighPriority);
+
+	const double StallMs = (FPlatformTime::Seconds() - InputAssetsRequestTime) * 1000.0;
+	UE_LOG(LogTemp, Display, TEXT("🐸 Input assets requested (game thread stall: %.3f ms)"), StallMs);
+}
+
+void AFroggyCharacter::OnInputAssetsLoaded()
+{
+	const double LoadMs = (FPlatformTime::Seconds() - InputAssetsRequestTime) * 1000.0;
+
+	if (!AreInputAssetsLoaded())
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Failed to load one or more input assets (after %.3f ms)!"), LoadMs);
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("🐸 Successfully loaded input assets in %.3f ms (%s)"), LoadMs,
+		CVarFroggySyncLoadInputAssets.GetValueOnGameThread() ? TEXT("sync") : TEXT("async"));
+
+	// The controller might not be known yet if the bundle finished before we were possessed - then BeginPlay
+	// of the ProtagonistController picks it up instead.
+	ProtagonistController = Cast<AProtagonistController>(GetController());
+	if (ProtagonistController)
+	{
+		ProtagonistController->SetupFroggyInput(this);
 	}
 }
 
 void AFroggyCharacter::Move(const FInputActionValue& Value)
 {
 	FVector2D MovementVector = Value.Get<FVector2D>();
+
+	// Froggy has to stand up first.
+	if (bIsSitting) return;
 	
 	if (ProtagonistController)
 	{
@@ -204,64 +363,382 @@ void AFroggyCharacter::Sit(const FInputActionValue& Value)
 	
 	if (bool bPressed = Value.Get<bool>())
 	{
-		bIsSitting = !bIsSitting;
+		SetSitting(!bIsSitting);
+		UFroggyTelemetrySubsystem::Record(this, EFroggyTelemetryEvent::Sit, bIsSitting ? 1.0f : 0.0f);
+
+		// Set it locally right away so it feels instant, and tell the server so everybody else sees it.
+		if (!HasAuthority())
+		{
+			Server_SetSitting(bIsSitting);
+		}
 		
-		UE_LOG(LogTemp, Display, TEXT("Froggy is now sitting"));
-		// TODO: Perform sitting logic here. :)
+		// The sit/stand animation comes from bIsSitting in UFroggyAnimInstance, movement is handled in SetSitting.
+		UE_LOG(LogTemp, Display, TEXT("Froggy is now %s"), bIsSitting ? TEXT("sitting") : TEXT("standing"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Display, TEXT("Froggy is no longer sitting"));
-		// TODO: Handle standing up logic here. :)
+		UE_LOG(LogTemp, Display, TEXT("Froggy let go of the sit button"));
 	}
 }
 
 void AFroggyCharacter::CheckForNearbyItems()
 {
-	UE_LOG(LogTemp, Display, TEXT("Checking for nearby items..."));
-	TArray<AActor*> NearbyItems;
-	GetOverlappingActors(NearbyItems, AInteractableItem::StaticClass());
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_CheckForNearbyItems);
+
+	UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>();
+	if (!ItemIndex) return;
 
-	for (AActor* Actor : NearbyItems)
+	// Async: the last sweep's answer isn't in yet. Its pickups will change what's around, so wait for them first.
+	const bool bAsync = InteractionQuery::GetMode() == EInteractionQueryMode::AsyncPhysics;
+	if (bAsync && PickupQueryHandle.IsValid() && GetWorld()->IsTraceHandleValid(PickupQueryHandle, false))
 	{
-		AInteractableItem* Item = Cast<AInteractableItem>(Actor);
-		if (Item && FVector::Dist(Item->GetActorLocation(), GetActorLocation()) <= PickupRadius)
+		FROGGY_INC_COUNTER(STAT_Froggy_NearbyChecksSkipped, 1);
+		return;
+	}
+
+	const FVector Location = GetActorLocation();
+
+	// Standing still, and no item was added/moved anywhere since last time? Then nothing new can be in reach.
+	if (bHasPickupCheckLocation && Location.Equals(LastPickupCheckLocation, 1.0f) && ItemIndex->GetRevision() == LastPickupCheckRevision)
+	{
+		FROGGY_INC_COUNTER(STAT_Froggy_NearbyChecksSkipped, 1);
+		return;
+	}
+
+	FROGGY_INC_COUNTER(STAT_Froggy_NearbyChecks, 1);
+
+	// This runs a lot - "stat Froggy" shows how often and how long, so no need to log each one.
+	UE_LOG(LogTemp, Verbose, TEXT("Checking for nearby items..."));
+
+	// Sweep the pickup sphere along the way Froggy came since the last check, instead of only looking around where
+	// Froggy is now - so running past an item between two checks still picks it up.
+	// A huge jump is a teleport/respawn though, and we don't want to collect everything in a line across the level.
+	const bool bSweep = bHasPickupCheckLocation && FVector::DistSquared(LastPickupCheckLocation, Location) <= FMath::Square(MaxSweepDistance);
+	const FVector SweepStart = bSweep ? LastPickupCheckLocation : Location;
+
+	TArray<AInteractableItem*> NearbyItems;
+	switch (InteractionQuery::GetMode())
+	{
+	case EInteractionQueryMode::SpatialHash:
+		ItemIndex->QueryItemsAlongPath(SweepStart, Location, PickupRadius, NearbyItems);
+		break;
+
+	case EInteractionQueryMode::SyncPhysics:
+		InteractionQuery::SweepItems(GetWorld(), SweepStart, Location, PickupRadius, this, NearbyItems);
+		break;
+
+	case EInteractionQueryMode::AsyncPhysics:
+		// The physics work runs alongside the rest of the frame; the pickups happen next frame in OnAsyncPickupQueryDone,
+		// which also takes the revision - the one from now is stale as soon as those pickups happen.
+		PickupQueryHandle = InteractionQuery::AsyncSweepItems(GetWorld(), SweepStart, Location, PickupRadius, this,
+			FTraceDelegate::CreateUObject(this, &AFroggyCharacter::OnAsyncPickupQueryDone));
+		LastPickupCheckLocation = Location;
+		bHasPickupCheckLocation = true;
+		return;
+	}
+
+	PickupFoundItems(NearbyItems);
+
+	// Read after the pickups, so anything they changed in the hash doesn't make the next check run for nothing.
+	LastPickupCheckLocation = Location;
+	LastPickupCheckRevision = ItemIndex->GetRevision();
+	bHasPickupCheckLocation = true;
+}
+
+void AFroggyCharacter::OnAsyncPickupQueryDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	PickupQueryHandle = FTraceHandle();
+
+	TArray<AInteractableItem*> NearbyItems;
+	InteractionQuery::GetSweepResultItems(Datum, PickupRadius, NearbyItems);
+	PickupFoundItems(NearbyItems);
+
+	if (const UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		LastPickupCheckRevision = ItemIndex->GetRevision();
+	}
+}
+
+void AFroggyCharacter::PickupFoundItems(const TArray<AInteractableItem*>& Items)
+{
+	FROGGY_INC_COUNTER(STAT_Froggy_NearbyItemsFound, Items.Num());
+
+	if (!HasAuthority())
+	{
+		// Working on a copy of the results, since picking up an item removes it from the spatial hash.
+		for (AInteractableItem* Item : Items)
 		{
-			// Gotta cast(?) the AActor found (which is filtered) to be AInteractableItem for the function.
 			PickupAnItem(Item);
 		}
+		return;
+	}
+
+	// On the server, everything the check got goes into the inventory in one go.
+	TArray<FName, TInlineAllocator<32>> PickedUp;
+	for (AInteractableItem* Item : Items)
+	{
+		FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_PickupAnItem);
+
+		if (Item->PickupItem())
+		{
+			PickedUp.Add(Item->GetInventoryId());
+		}
+	}
+	Inventory->AddItems(PickedUp);
+}
+
+bool AFroggyCharacter::ShouldCheckForPickups() const
+{
+	return IsLocallyControlled() || (HasAuthority() && !IsPlayerControlled());
+}
+
+void AFroggyCharacter::UpdatePickupCheck()
+{
+	// Turned off while the timer was pending - don't reschedule, SetPickupChecksEnabled starts it again.
+	if (!bPickupChecksEnabled) return;
+
+	if (ShouldCheckForPickups())
+	{
+		CheckForNearbyItems();
+	}
+
+	// Aim for a check about every half pickup radius travelled. The sweep already makes sure nothing is missed, this
+	// just keeps the swept paths short (cheap) and the pickups from happening noticeably late.
+	const float Speed = GetVelocity().Size();
+	const float NextInterval = Speed > KINDA_SMALL_NUMBER
+		? FMath::Clamp(PickupRadius * 0.5f / Speed, MinPickupCheckInterval, PickupCheckTimeInterval)
+		: PickupCheckTimeInterval;
+
+	GetWorld()->GetTimerManager().SetTimer(PickupTimerHandle, this, &AFroggyCharacter::UpdatePickupCheck, NextInterval, false);
+}
+
+void AFroggyCharacter::SetPickupChecksEnabled(bool bEnabled)
+{
+	if (bPickupChecksEnabled == bEnabled) return;
+	bPickupChecksEnabled = bEnabled;
+
+	if (bEnabled)
+	{
+		// Start fresh from here, instead of sweeping the whole way Froggy walked while the checks were off.
+		bHasPickupCheckLocation = false;
+		GetWorld()->GetTimerManager().SetTimer(PickupTimerHandle, this, &AFroggyCharacter::UpdatePickupCheck, PickupCheckTimeInterval, false);
+	}
+	else
+	{
+		GetWorld()->GetTimerManager().ClearTimer(PickupTimerHandle);
 	}
 }
 
 void AFroggyCharacter::PickupAnItem(AInteractableItem* Item)
 {
-	UE_LOG(LogTemp, Display, TEXT("PickupAnItem() from Froggy called to: %s"), *Item->GetName());
-	Item->PickupItem();
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_PickupAnItem);
+
+	UE_LOG(LogTemp, Verbose, TEXT("PickupAnItem() from Froggy called to: %s"), *Item->GetName());
+
+	if (HasAuthority())
+	{
+		if (Item->PickupItem())
+		{
+			Inventory->AddItem(Item->GetInventoryId());
+		}
+	}
+	else if (Item->bIsAPickup && !HasPendingPrediction(Item))
+	{
+		RequestItemAction(Item, true);
+	}
 }
 
 // When Interact Input is received.
 void AFroggyCharacter::Interact()
 {
-	// If... I have to manually find the playerLocation.
-	// FVector PlayerLocation = GetActorLocation();
-	
-	TArray<AActor*> OverlappingActors;
-	
-	// The below functions just detects if the PlayerCollision overlaps with an AInteractableItem.
-	GetOverlappingActors(OverlappingActors, AInteractableItem::StaticClass());
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_Interact);
 
-	for (AActor* Actor : OverlappingActors)
+	// The focus component ranks everything in reach (distance + is it in front of Froggy) - interact with the winner.
+	if (AInteractableItem* Item = InteractionFocus->SelectBestTarget())
 	{
-		AInteractableItem* Item = Cast<AInteractableItem>(Actor);
-		if (Item)
+		// Clients pick the target (they know where the player is looking), the server does the actual interaction.
+		// The client doesn't wait for it though - see RequestItemAction.
+		if (HasAuthority())
 		{
 			Item->Interact();
-			UE_LOG(LogTemp, Warning, TEXT("Froggy is interacting with %s!"), *Item->GetName());
-			return;
 		}
+		else
+		{
+			RequestItemAction(Item, false);
+		}
+
+		UE_LOG(LogTemp, Verbose, TEXT("Froggy is interacting with %s!"), *Item->GetName());
+		return;
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("Froggy is interacting - but no interactable nearby!"));
+	UE_LOG(LogTemp, Verbose, TEXT("Froggy is interacting - but no interactable nearby!"));
+}
+
+void AFroggyCharacter::RequestItemAction(AInteractableItem* Item, bool bPickup)
+{
+	FPendingPrediction Pending;
+	Pending.Item = Item;
+	Pending.SentTime = FPlatformTime::Seconds();
+	Pending.bWasPickup = bPickup;
+
+	if (CVarFroggyPredict.GetValueOnGameThread())
+	{
+		Pending.bPredicted = bPickup ? Item->PredictPickup() : Item->PredictInteract();
+
+		// Nothing to predict means the item is already taken as far as we know - no point asking the server.
+		if (!Pending.bPredicted) return;
+
+		++PredictionStats.NumPredicted;
+		FROGGY_INC_COUNTER(STAT_Froggy_Predictions, 1);
+	}
+
+	// Skip 0, so a key of 0 can never be mistaken for a real one.
+	const uint16 PredictionKey = NextPredictionKey;
+	NextPredictionKey = NextPredictionKey == MAX_uint16 ? 1 : NextPredictionKey + 1;
+
+	PendingPredictions.Add(PredictionKey, Pending);
+	++PredictionStats.NumRequests;
+
+	if (bPickup)
+	{
+		Server_PickupItem(Item, PredictionKey);
+	}
+	else
+	{
+		Server_Interact(Item, PredictionKey);
+	}
+}
+
+bool AFroggyCharacter::HasPendingPrediction(const AInteractableItem* Item) const
+{
+	for (const TPair<uint16, FPendingPrediction>& Pair : PendingPredictions)
+	{
+		if (Pair.Value.Item.Get() == Item)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AFroggyCharacter::IsInReachOnServer(const AInteractableItem* Item, float Radius) const
+{
+	const float MaxDistance = Radius + ServerInteractTolerance;
+	return FVector::DistSquared(GetActorLocation(), Item->GetActorLocation()) <= FMath::Square(MaxDistance);
+}
+
+bool AFroggyCharacter::Server_Interact_Validate(AInteractableItem* Item, uint16 PredictionKey)
+{
+	// Failing validation kicks the client, so only reject things a normal client can never send.
+	// (An item that's just out of reach or already taken is normal with lag - that's handled below, not kicked.)
+	return Item == nullptr || Item->GetWorld() == GetWorld();
+}
+
+void AFroggyCharacter::Server_Interact_Implementation(AInteractableItem* Item, uint16 PredictionKey)
+{
+	if (!IsValid(Item) || Item->IsPooled() || Item->IsClaimed())
+	{
+		Client_AckPrediction(PredictionKey, false, false);
+		return;
+	}
+
+	if (!IsInReachOnServer(Item, InteractRadius))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("❌ Rejected interact from %s: %s is out of reach."), *GetName(), *Item->GetName());
+		Client_AckPrediction(PredictionKey, false, true);
+		return;
+	}
+
+	Item->Interact();
+	Client_AckPrediction(PredictionKey, true, true);
+}
+
+bool AFroggyCharacter::Server_PickupItem_Validate(AInteractableItem* Item, uint16 PredictionKey)
+{
+	return Item == nullptr || Item->GetWorld() == GetWorld();
+}
+
+void AFroggyCharacter::Server_PickupItem_Implementation(AInteractableItem* Item, uint16 PredictionKey)
+{
+	if (!IsValid(Item) || !Item->bIsAPickup || Item->IsPooled() || Item->IsClaimed())
+	{
+		Client_AckPrediction(PredictionKey, false, false);
+		return;
+	}
+
+	// The client swept the path it walked, so the item can be a bit behind where the server has Froggy now.
+	if (!IsInReachOnServer(Item, PickupRadius))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("❌ Rejected pickup from %s: %s is out of reach."), *GetName(), *Item->GetName());
+		Client_AckPrediction(PredictionKey, false, true);
+		return;
+	}
+
+	if (Item->PickupItem())
+	{
+		Inventory->AddItem(Item->GetInventoryId());
+	}
+	Client_AckPrediction(PredictionKey, true, true);
+}
+
+void AFroggyCharacter::Client_AckPrediction_Implementation(uint16 PredictionKey, bool bAccepted, bool bStillAvailable)
+{
+	FPendingPrediction Pending;
+	if (!PendingPredictions.RemoveAndCopyValue(PredictionKey, Pending)) return;
+
+	const double RoundTripMs = (FPlatformTime::Seconds() - Pending.SentTime) * 1000.0;
+	PredictionStats.TotalRoundTripMs += RoundTripMs;
+	PredictionStats.MaxRoundTripMs = FMath::Max(PredictionStats.MaxRoundTripMs, RoundTripMs);
+
+	if (bAccepted)
+	{
+		++PredictionStats.NumConfirmed;
+		return;
+	}
+
+	++PredictionStats.NumRejected;
+
+	if (Pending.bPredicted)
+	{
+		FROGGY_INC_COUNTER(STAT_Froggy_Mispredictions, 1);
+
+		if (AInteractableItem* Item = Pending.Item.Get())
+		{
+			UE_LOG(LogTemp, Display, TEXT("Server said no to %s on %s after %.0f ms - rolling back."),
+				Pending.bWasPickup ? TEXT("pickup") : TEXT("interact"), *Item->GetName(), RoundTripMs);
+			Item->RollbackPrediction(Pending.bWasPickup, bStillAvailable);
+		}
+	}
+}
+
+void AFroggyCharacter::LogPredictionStats() const
+{
+	const FPredictionStats& Stats = PredictionStats;
+	const int32 NumAnswered = Stats.NumConfirmed + Stats.NumRejected;
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 %s: %d requests (%d predicted), %d confirmed, %d rejected (%.1f%%), %d waiting"),
+		*GetName(), Stats.NumRequests, Stats.NumPredicted, Stats.NumConfirmed, Stats.NumRejected,
+		Stats.NumRequests > 0 ? 100.0 * Stats.NumRejected / Stats.NumRequests : 0.0, PendingPredictions.Num());
+	UE_LOG(LogTemp, Display, TEXT("🐸 Round trip %s: avg %.1f ms, max %.1f ms"),
+		Stats.NumPredicted > 0 ? TEXT("hidden by prediction") : TEXT("waited for"),
+		NumAnswered > 0 ? Stats.TotalRoundTripMs / NumAnswered : 0.0, Stats.MaxRoundTripMs);
+}
+
+void AFroggyCharacter::Server_SetSitting_Implementation(bool bNewIsSitting)
+{
+	SetSitting(bNewIsSitting);
+}
+
+void AFroggyCharacter::SetSitting(bool bNewIsSitting)
+{
+	bIsSitting = bNewIsSitting;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AFroggyCharacter, bIsSitting, this);
+
+	// Sitting down stops Froggy where it is (Move ignores input while sitting), so it doesn't slide into the sit.
+	if (bIsSitting)
+	{
+		GetCharacterMovement()->StopMovementImmediately();
+	}
 }
 
 // For hold interactions:
@@ -276,6 +753,7 @@ void AFroggyCharacter::StartInteract(const FInputActionValue& Value)
 void AFroggyCharacter::StopInteract(const FInputActionValue& Value)
 {
 	GetWorld()->GetTimerManager().ClearTimer(InteractHoldTimerHandle); // stop tracking timer
+	UFroggyTelemetrySubsystem::Record(this, EFroggyTelemetryEvent::HoldInteract, InteractHoldTime);
 
 	if (InteractHoldTime >= InteractHoldTimeThreshold) // For example, hold for 1.5 seconds = Long Interact, else Short Interact
 	{
@@ -304,5 +782,9 @@ void AFroggyCharacter::PerformShortInteract()
 void AFroggyCharacter::PerformLongInteract()
 {
 	UE_LOG(LogTemp, Display, TEXT("Froggy does a long interact!"));
+	++LongInteractCount; // The anim instance picks this up and plays the door opening
+
+	// Re-rank right before the event, so Blueprints see the same target a short interact would have picked.
+	InteractionFocus->SelectBestTarget();
 	OnInteract(true);
 }
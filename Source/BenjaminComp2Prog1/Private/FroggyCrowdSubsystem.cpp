@@ -0,0 +1,355 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyCrowdSubsystem.h"
+#include "FroggyCharacter.h"
+#include "FroggyStats.h"
+#include "SignificanceManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static const FName FroggyCrowdTag(TEXT("FroggyCrowd"));
+
+static TAutoConsoleVariable<bool> CVarFroggyCrowdEnable(
+	TEXT("Froggy.Crowd.Enable"),
+	true,
+	TEXT("Rank AI Froggies by significance and give the far/hidden ones less work. 0 = everyone at full detail."));
+
+static FAutoConsoleCommandWithWorld GFroggyCrowdStatsCommand(
+	TEXT("Froggy.Crowd.Stats"),
+	TEXT("Prints how many AI Froggies are in each crowd tier."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFroggyCrowdSubsystem* Crowd = World ? World->GetSubsystem<UFroggyCrowdSubsystem>() : nullptr)
+		{
+			const FFroggyCrowdStats Stats = Crowd->GetStats();
+			UE_LOG(LogTemp, Display, TEXT("🐸 Crowd: %d Froggies - %d full, %d reduced, %d shared pose, %d dormant (%d changed last update)"),
+				Stats.NumRegistered, Stats.NumFull, Stats.NumReduced, Stats.NumShared, Stats.NumDormant, Stats.NumChanged);
+		}
+	}));
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs GFroggyCrowdSpawnCommand(
+	TEXT("Froggy.Crowd.Spawn"),
+	TEXT("Froggy.Crowd.Spawn [Count] - spawns Count (default 100) AI Froggies in a grid in front of the player. Server only."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World || World->GetNetMode() == NM_Client) return;
+
+		const APlayerController* PlayerController = World->GetFirstPlayerController();
+		const AFroggyCharacter* Player = PlayerController ? Cast<AFroggyCharacter>(PlayerController->GetPawn()) : nullptr;
+		if (!Player)
+		{
+			UE_LOG(LogTemp, Error, TEXT("❌ Froggy.Crowd.Spawn needs a player Froggy to spawn around"));
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 100;
+		const int32 Columns = FMath::Max(FMath::CeilToInt32(FMath::Sqrt(float(Count))), 1);
+		const float Spacing = 250.0f;
+
+		// Same class as the player, so they get the same mesh - that's what lets them share poses.
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+
+		const FVector Forward = Player->GetActorForwardVector();
+		const FVector Right = Player->GetActorRightVector();
+		int32 NumSpawned = 0;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const float Row = float(Index / Columns + 1);
+			const float Column = float(Index % Columns) - Columns * 0.5f;
+			const FVector Location = Player->GetActorLocation() + Forward * Row * Spacing + Right * Column * Spacing;
+
+			if (AFroggyCharacter* Froggy = World->SpawnActor<AFroggyCharacter>(Player->GetClass(), Location, Player->GetActorRotation(), SpawnParams))
+			{
+				Froggy->SpawnDefaultController();
+				++NumSpawned;
+			}
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("🐸 Spawned %d of %d crowd Froggies"), NumSpawned, Count);
+	}));
+#endif
+
+bool UFroggyCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFroggyCrowdSubsystem::Deinitialize()
+{
+	// The significance manager goes away with the world, no need to unregister from it.
+	Members.Empty();
+	LeaderActor = nullptr;
+	for (TObjectPtr<USkeletalMeshComponent>& Leader : Leaders)
+	{
+		Leader = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UFroggyCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFroggyCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UFroggyCrowdSubsystem::RegisterFroggy(AFroggyCharacter* Froggy)
+{
+	if (!Froggy || Members.Contains(Froggy)) return;
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+	if (!SignificanceManager)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ No significance manager in this world, is the SignificanceManager plugin enabled?"));
+		return;
+	}
+
+	Members.Add(Froggy);
+
+	// Called for every view, possibly on worker threads (the manager runs these in a ParallelFor), so only reads.
+	// On a dedicated server nothing is ever rendered, so visibility doesn't count there.
+	const bool bUseVisibility = GetWorld()->GetNetMode() != NM_DedicatedServer;
+	const float HiddenScale = HiddenDistanceScale;
+	SignificanceManager->RegisterObject(Froggy, FroggyCrowdTag,
+		[bUseVisibility, HiddenScale](USignificanceManager::FManagedObjectInfo* Info, const FTransform& Viewpoint)
+		{
+			const AFroggyCharacter* CrowdFroggy = static_cast<const AFroggyCharacter*>(Info->GetObject());
+
+			float Distance = FVector::Dist(CrowdFroggy->GetActorLocation(), Viewpoint.GetLocation());
+			if (bUseVisibility && !CrowdFroggy->GetMesh()->WasRecentlyRendered(0.25f))
+			{
+				Distance *= HiddenScale;
+			}
+			return DistanceToSignificance(Distance);
+		});
+}
+
+void UFroggyCrowdSubsystem::UnregisterFroggy(AFroggyCharacter* Froggy)
+{
+	FCrowdMember Member;
+	if (!Members.RemoveAndCopyValue(Froggy, Member)) return;
+
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterObject(Froggy);
+	}
+
+	// Leave it the way we found it
+	if (Member.Tier != EFroggyCrowdTier::Full)
+	{
+		ApplyTier(Froggy, Member, EFroggyCrowdTier::Full);
+	}
+}
+
+void UFroggyCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_CrowdUpdate);
+
+	// Switched off: everyone back to full detail once, then nothing.
+	if (!CVarFroggyCrowdEnable.GetValueOnGameThread())
+	{
+		if (bWasEnabled)
+		{
+			for (TPair<AFroggyCharacter*, FCrowdMember>& Pair : Members)
+			{
+				ApplyTier(Pair.Key, Pair.Value, EFroggyCrowdTier::Full);
+			}
+			bWasEnabled = false;
+		}
+		Stats = FFroggyCrowdStats();
+		Stats.NumRegistered = Stats.NumFull = Members.Num();
+		return;
+	}
+	bWasEnabled = true;
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+	if (!SignificanceManager || Members.Num() == 0) return;
+
+	GatherViewpoints();
+	if (Viewpoints.Num() == 0) return;
+
+	// 1. Score everyone (parallel), the manager sorts them most significant first.
+	SignificanceManager->Update(Viewpoints);
+
+	// 2. Walk the ranked list and hand out tiers. Only Froggies whose tier changed are touched.
+	Stats = FFroggyCrowdStats();
+	Stats.NumRegistered = Members.Num();
+
+	for (const USignificanceManager::FManagedObjectInfo* Info : SignificanceManager->GetManagedObjects(FroggyCrowdTag))
+	{
+		AFroggyCharacter* Froggy = static_cast<AFroggyCharacter*>(Info->GetObject());
+		FCrowdMember* Member = Members.Find(Froggy);
+		if (!Member) continue;
+
+		EFroggyCrowdTier NewTier = GetTierForDistance(SignificanceToDistance(Info->GetSignificance()), Member->Tier);
+		if (NewTier == EFroggyCrowdTier::Full && Stats.NumFull >= MaxFullDetail)
+		{
+			NewTier = EFroggyCrowdTier::Reduced;
+		}
+
+		if (NewTier != Member->Tier)
+		{
+			ApplyTier(Froggy, *Member, NewTier);
+			++Stats.NumChanged;
+		}
+
+		switch (NewTier)
+		{
+		case EFroggyCrowdTier::Full:	++Stats.NumFull; break;
+		case EFroggyCrowdTier::Reduced:	++Stats.NumReduced; break;
+		case EFroggyCrowdTier::Shared:	++Stats.NumShared; break;
+		case EFroggyCrowdTier::Dormant:	++Stats.NumDormant; break;
+		}
+	}
+
+	FROGGY_INC_COUNTER(STAT_Froggy_CrowdTierChanges, Stats.NumChanged);
+
+	// 3. Now and then, make the pose sharers follow the leader that matches what they're doing.
+	LeaderRecheckTime += DeltaTime;
+	if (LeaderRecheckTime >= LeaderRecheckInterval)
+	{
+		LeaderRecheckTime = 0.0f;
+		for (const TPair<AFroggyCharacter*, FCrowdMember>& Pair : Members)
+		{
+			if (Pair.Value.Tier <= EFroggyCrowdTier::Shared)
+			{
+				ApplyLeader(Pair.Key, Pair.Value);
+			}
+		}
+	}
+}
+
+EFroggyCrowdTier UFroggyCrowdSubsystem::GetTierForDistance(float Distance, EFroggyCrowdTier CurrentTier) const
+{
+	// By EFroggyCrowdTier. Dormant has no limit.
+	const float Limits[] = { MAX_flt, SharedDistance, ReducedDistance, FullDetailDistance };
+
+	// The best tier the Froggy is close enough for. The tier it's already in (and the ones below) get a bit of slack.
+	for (uint8 Tier = uint8(EFroggyCrowdTier::Full); Tier > uint8(EFroggyCrowdTier::Dormant); --Tier)
+	{
+		const float Limit = Tier <= uint8(CurrentTier) ? Limits[Tier] * (1.0f + Hysteresis) : Limits[Tier];
+		if (Distance <= Limit)
+		{
+			return EFroggyCrowdTier(Tier);
+		}
+	}
+	return EFroggyCrowdTier::Dormant;
+}
+
+void UFroggyCrowdSubsystem::ApplyTier(AFroggyCharacter* Froggy, FCrowdMember& Member, EFroggyCrowdTier NewTier)
+{
+	Member.Tier = NewTier;
+
+	// By EFroggyCrowdTier
+	const float MovementTickIntervals[] = { DormantMovementTickInterval, SharedMovementTickInterval, ReducedMovementTickInterval, 0.0f };
+	if (UCharacterMovementComponent* Movement = Froggy->GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(MovementTickIntervals[uint8(NewTier)]);
+	}
+
+	// AlwaysTickPose is what ACharacter gives its mesh. Below Full, nobody needs a pose they can't see.
+	if (USkeletalMeshComponent* Mesh = Froggy->GetMesh())
+	{
+		Mesh->VisibilityBasedAnimTickOption = NewTier == EFroggyCrowdTier::Full
+			? EVisibilityBasedAnimTickOption::AlwaysTickPose
+			: EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+
+	Froggy->SetPickupChecksEnabled(NewTier >= EFroggyCrowdTier::Reduced);
+
+	ApplyLeader(Froggy, Member);
+}
+
+void UFroggyCrowdSubsystem::ApplyLeader(AFroggyCharacter* Froggy, const FCrowdMember& Member)
+{
+	USkeletalMeshComponent* Mesh = Froggy->GetMesh();
+	if (!Mesh) return;
+
+	const bool bSharePose = Member.Tier <= EFroggyCrowdTier::Shared && GetWorld()->GetNetMode() != NM_DedicatedServer;
+	USkeletalMeshComponent* Leader = bSharePose ? GetLeader(GetLeaderState(Froggy), Mesh->GetSkeletalMeshAsset()) : nullptr;
+
+	// SetLeaderPoseComponent re-links all the bones, so only when it actually changes.
+	if (Mesh->LeaderPoseComponent.Get() != Leader)
+	{
+		Mesh->SetLeaderPoseComponent(Leader);
+	}
+}
+
+EFroggyAnimState UFroggyCrowdSubsystem::GetLeaderState(const AFroggyCharacter* Froggy)
+{
+	// No door leader, that one's over too quick to be worth it from far away.
+	if (Froggy->GetIsSitting()) return EFroggyAnimState::Sit;
+
+	// Same as UFroggyAnimInstance::WalkStartSpeed
+	return Froggy->GetVelocity().SizeSquared2D() > FMath::Square(10.0f) ? EFroggyAnimState::Walk : EFroggyAnimState::Idle;
+}
+
+USkeletalMeshComponent* UFroggyCrowdSubsystem::GetLeader(EFroggyAnimState State, USkeletalMesh* Mesh)
+{
+	if (!Mesh) return nullptr;
+
+	// Leader and followers have to be the same mesh. A Froggy with some other mesh just keeps its own animation.
+	TObjectPtr<USkeletalMeshComponent>& Leader = Leaders[uint8(State)];
+	if (Leader)
+	{
+		return Leader->GetSkeletalMeshAsset() == Mesh ? Leader.Get() : nullptr;
+	}
+
+	if (!LeaderActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("FroggyCrowdPoseLeaders");
+		SpawnParams.ObjectFlags |= RF_Transient;
+		LeaderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	Leader = NewObject<USkeletalMeshComponent>(LeaderActor);
+	Leader->SetSkeletalMeshAsset(Mesh);
+	Leader->SetAnimInstanceClass(UFroggyAnimInstance::StaticClass());
+	Leader->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Leader->SetHiddenInGame(true);
+
+	// Never seen itself, but the followers need its bones every frame
+	Leader->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	if (USceneComponent* Root = LeaderActor->GetRootComponent())
+	{
+		Leader->SetupAttachment(Root);
+	}
+	else
+	{
+		LeaderActor->SetRootComponent(Leader);
+	}
+	Leader->RegisterComponent();
+
+	if (UFroggyAnimInstance* AnimInstance = Cast<UFroggyAnimInstance>(Leader->GetAnimInstance()))
+	{
+		AnimInstance->SetForcedState(State);
+	}
+
+	return Leader;
+}
+
+void UFroggyCrowdSubsystem::GatherViewpoints()
+{
+	// Every player's view - on a server that includes the remote players, so their surroundings stay detailed too.
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Emplace(Rotation, Location);
+		}
+	}
+}
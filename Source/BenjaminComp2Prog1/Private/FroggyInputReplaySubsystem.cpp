@@ -0,0 +1,431 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyInputReplaySubsystem.h"
+#include "FroggyCharacter.h"
+#include "EnhancedInputSubsystems.h"
+#include "EnhancedPlayerInput.h"
+#include "InputAction.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const TCHAR* DefaultRecordingName = TEXT("Froggy");
+
+static FAutoConsoleCommandWithWorldAndArgs GFroggyInputRecordCommand(
+	TEXT("Froggy.Input.Record"),
+	TEXT("Records the local Froggy's input until Froggy.Input.Stop. Usage: Froggy.Input.Record [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UFroggyInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFroggyInputReplaySubsystem>() : nullptr)
+		{
+			Replay->StartRecording(Args.Num() > 0 ? Args[0] : DefaultRecordingName);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GFroggyInputReplayCommand(
+	TEXT("Froggy.Input.Replay"),
+	TEXT("Replays recorded input with a fixed timestep. Usage: Froggy.Input.Replay [Name] [StepSeconds]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UFroggyInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFroggyInputReplaySubsystem>() : nullptr)
+		{
+			Replay->StartReplay(Args.Num() > 0 ? Args[0] : DefaultRecordingName, Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.0f, false);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld GFroggyInputStopCommand(
+	TEXT("Froggy.Input.Stop"),
+	TEXT("Stops the input recording (and saves it) or the replay (and writes its timings)."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UFroggyInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFroggyInputReplaySubsystem>() : nullptr)
+		{
+			Replay->Stop();
+		}
+	}));
+
+namespace FroggyInputReplay
+{
+	// How many floats a value of this type takes in the file
+	static int32 GetNumComponents(uint8 ValueType)
+	{
+		switch (EInputActionValueType(ValueType))
+		{
+		case EInputActionValueType::Axis2D: return 2;
+		case EInputActionValueType::Axis3D: return 3;
+		default: return 1; // Boolean, Axis1D
+		}
+	}
+
+	static double GetPercentile(const TArray<float>& SortedMs, double Percentile)
+	{
+		return SortedMs.Num() > 0 ? SortedMs[FMath::Min(SortedMs.Num() - 1, FMath::FloorToInt32(SortedMs.Num() * Percentile))] : 0.0;
+	}
+}
+
+bool UFroggyInputReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFroggyInputReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFroggyInputReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UFroggyInputReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// -FroggyReplay=<Name> [-FroggyReplayStep=<Seconds>] [-FroggyReplayQuit], or -FroggyRecord=<Name>
+	FString Name;
+	if (FParse::Value(FCommandLine::Get(), TEXT("FroggyReplay="), Name))
+	{
+		float Step = 0.0f;
+		FParse::Value(FCommandLine::Get(), TEXT("FroggyReplayStep="), Step);
+		StartReplay(Name, Step, FParse::Param(FCommandLine::Get(), TEXT("FroggyReplayQuit")));
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("FroggyRecord="), Name))
+	{
+		StartRecording(Name);
+	}
+}
+
+void UFroggyInputReplaySubsystem::Deinitialize()
+{
+	// Leaving the map ends whatever was going on, but keeps what we have so far.
+	Stop();
+
+	Super::Deinitialize();
+}
+
+FString UFroggyInputReplaySubsystem::GetRecordingPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / (Name + TEXT(".finp"));
+}
+
+bool UFroggyInputReplaySubsystem::StartRecording(const FString& Name)
+{
+	if (Mode != EMode::None)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Already recording or replaying input - Froggy.Input.Stop first"));
+		return false;
+	}
+
+	Mode = EMode::Recording;
+	CurrentName = Name;
+	Frames.Reset();
+	FMemory::Memzero(ValueTypes);
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 Recording input to %s"), *GetRecordingPath(Name));
+	return true;
+}
+
+bool UFroggyInputReplaySubsystem::StartReplay(const FString& Name, float FixedStep, bool bInQuitWhenDone)
+{
+	if (Mode != EMode::None)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Already recording or replaying input - Froggy.Input.Stop first"));
+		return false;
+	}
+
+	const FString Path = GetRecordingPath(Name);
+	if (!ReadRecording(Path, ValueTypes, Frames) || Frames.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not read an input recording from %s"), *Path);
+		return false;
+	}
+
+	// No step given: the recording's average frame time, so the replay covers about the same game time.
+	if (FixedStep <= 0.0f)
+	{
+		double TotalSeconds = 0.0;
+		for (const FFroggyInputFrame& Frame : Frames)
+		{
+			TotalSeconds += Frame.DeltaSeconds;
+		}
+		FixedStep = FMath::Clamp(float(TotalSeconds / Frames.Num()), 1.0f / 240.0f, 0.1f);
+	}
+
+	// Fixed timestep: every replay runs exactly the same frames, however long they take, and the engine doesn't
+	// wait between them - so the frame times below are the actual cost of each frame.
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedStep);
+
+	Mode = EMode::Replaying;
+	CurrentName = Name;
+	NextReplayFrame = 0;
+	bQuitWhenDone = bInQuitWhenDone;
+	FrameTimesMs.Reset(Frames.Num());
+	LastFrameTime = 0.0;
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 Replaying %d frames of input from %s with a %.4f s fixed step"), Frames.Num(), *Path, FixedStep);
+	return true;
+}
+
+void UFroggyInputReplaySubsystem::Stop()
+{
+	if (Mode == EMode::Recording)
+	{
+		FinishRecording();
+	}
+	else if (Mode == EMode::Replaying)
+	{
+		FinishReplay();
+	}
+}
+
+void UFroggyInputReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Mode == EMode::None) return;
+
+	UEnhancedInputLocalPlayerSubsystem* Input = nullptr;
+	const AFroggyCharacter* Froggy = GetReadyFroggy(Input);
+	if (!Froggy) return;
+
+	if (Mode == EMode::Recording)
+	{
+		RecordFrame(Froggy, Input, DeltaTime);
+		return;
+	}
+
+	// The time since the last replayed frame started is what that frame cost.
+	const double Now = FPlatformTime::Seconds();
+	if (LastFrameTime > 0.0)
+	{
+		FrameTimesMs.Add(float((Now - LastFrameTime) * 1000.0));
+	}
+	LastFrameTime = Now;
+
+	if (NextReplayFrame >= Frames.Num())
+	{
+		FinishReplay();
+		return;
+	}
+
+	ReplayFrame(Froggy, Input);
+}
+
+AFroggyCharacter* UFroggyInputReplaySubsystem::GetReadyFroggy(UEnhancedInputLocalPlayerSubsystem*& OutInput) const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	AFroggyCharacter* Froggy = PlayerController ? Cast<AFroggyCharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!Froggy || !Froggy->AreInputAssetsLoaded() || !Froggy->GetEnhancedInputComponent()) return nullptr;
+
+	OutInput = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer());
+	return OutInput && OutInput->GetPlayerInput() ? Froggy : nullptr;
+}
+
+const UInputAction* UFroggyInputReplaySubsystem::GetAction(const AFroggyCharacter* Froggy, EFroggyRecordedAction Action)
+{
+	switch (Action)
+	{
+	case EFroggyRecordedAction::Move:		return Froggy->GetIA_Move();
+	case EFroggyRecordedAction::Look:		return Froggy->GetIA_Look();
+	case EFroggyRecordedAction::Sit:		return Froggy->GetIA_Sit();
+	case EFroggyRecordedAction::Interact:	return Froggy->GetIA_Interact();
+	default:								return nullptr;
+	}
+}
+
+void UFroggyInputReplaySubsystem::RecordFrame(const AFroggyCharacter* Froggy, const UEnhancedInputLocalPlayerSubsystem* Input, float DeltaTime)
+{
+	const UEnhancedPlayerInput* PlayerInput = Input->GetPlayerInput();
+
+	FFroggyInputFrame& Frame = Frames.AddDefaulted_GetRef();
+	Frame.DeltaSeconds = DeltaTime;
+
+	for (uint8 Index = 0; Index < uint8(EFroggyRecordedAction::Count); ++Index)
+	{
+		const UInputAction* Action = GetAction(Froggy, EFroggyRecordedAction(Index));
+		if (!Action) continue;
+
+		ValueTypes[Index] = uint8(Action->ValueType);
+
+		const FInputActionValue Value = PlayerInput->GetActionValue(Action);
+		if (Value.IsNonZero())
+		{
+			Frame.ActiveMask |= 1 << Index;
+			Frame.Values[Index] = FVector3f(Value.Get<FVector>());
+		}
+	}
+}
+
+void UFroggyInputReplaySubsystem::ReplayFrame(const AFroggyCharacter* Froggy, UEnhancedInputLocalPlayerSubsystem* Input)
+{
+	const FFroggyInputFrame& Frame = Frames[NextReplayFrame++];
+
+	// A held action is injected every frame it was held, so Started/Triggered/Completed come out the same as live.
+	for (uint8 Index = 0; Index < uint8(EFroggyRecordedAction::Count); ++Index)
+	{
+		const UInputAction* Action = GetAction(Froggy, EFroggyRecordedAction(Index));
+		if (Action && (Frame.ActiveMask & (1 << Index)))
+		{
+			Input->InjectInputForAction(Action, FInputActionValue(EInputActionValueType(ValueTypes[Index]), FVector(Frame.Values[Index])), {}, {});
+		}
+	}
+}
+
+void UFroggyInputReplaySubsystem::FinishRecording()
+{
+	Mode = EMode::None;
+
+	const FString Path = GetRecordingPath(CurrentName);
+	if (WriteRecording(Path, ValueTypes, Frames))
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Saved %d frames of input to %s (%lld bytes)"), Frames.Num(), *Path, IFileManager::Get().FileSize(*Path));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not write the input recording to %s"), *Path);
+	}
+
+	Frames.Empty();
+}
+
+void UFroggyInputReplaySubsystem::FinishReplay()
+{
+	Mode = EMode::None;
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	// Per frame CSV, for plotting / diffing the distributions between builds
+	TArray<FString> Lines;
+	Lines.Reserve(FrameTimesMs.Num() + 1);
+	Lines.Add(TEXT("Frame,FrameMs"));
+	for (int32 Index = 0; Index < FrameTimesMs.Num(); ++Index)
+	{
+		Lines.Add(FString::Printf(TEXT("%d,%.4f"), Index, FrameTimesMs[Index]));
+	}
+
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("FroggyReplay")
+		/ FString::Printf(TEXT("%s-%s.csv"), *CurrentName, *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringArrayToFile(Lines, *CsvPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Wrote replay frame times to %s"), *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not write %s"), *CsvPath);
+	}
+
+	// And the summary right in the log
+	TArray<float> SortedMs = FrameTimesMs;
+	SortedMs.Sort();
+	double TotalMs = 0.0;
+	for (const float Ms : SortedMs)
+	{
+		TotalMs += Ms;
+	}
+	UE_LOG(LogTemp, Display, TEXT("🐸 Replay %s: %d of %d frames, mean %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f"),
+		*CurrentName, NextReplayFrame, Frames.Num(), SortedMs.Num() > 0 ? TotalMs / SortedMs.Num() : 0.0,
+		FroggyInputReplay::GetPercentile(SortedMs, 0.5), FroggyInputReplay::GetPercentile(SortedMs, 0.95),
+		FroggyInputReplay::GetPercentile(SortedMs, 0.99), SortedMs.Num() > 0 ? SortedMs.Last() : 0.0f);
+
+	Frames.Empty();
+	FrameTimesMs.Empty();
+
+	if (bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false, TEXT("FroggyInputReplay"));
+	}
+}
+
+bool UFroggyInputReplaySubsystem::WriteRecording(const FString& Path, const uint8 (&InValueTypes)[uint8(EFroggyRecordedAction::Count)], const TArray<FFroggyInputFrame>& InFrames)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+	uint8 NumActions = uint8(EFroggyRecordedAction::Count);
+	Ar << Magic << Version << NumActions;
+	for (uint8 Index = 0; Index < NumActions; ++Index)
+	{
+		uint8 ValueType = InValueTypes[Index];
+		Ar << ValueType;
+	}
+
+	uint32 NumFrames = InFrames.Num();
+	Ar << NumFrames;
+	for (const FFroggyInputFrame& Frame : InFrames)
+	{
+		float DeltaSeconds = Frame.DeltaSeconds;
+		uint8 ActiveMask = Frame.ActiveMask;
+		Ar << DeltaSeconds << ActiveMask;
+
+		// Only the actions that were active, and only as many components as their type has
+		for (uint8 Index = 0; Index < NumActions; ++Index)
+		{
+			if (!(ActiveMask & (1 << Index))) continue;
+
+			FVector3f Value = Frame.Values[Index];
+			const int32 NumComponents = FroggyInputReplay::GetNumComponents(InValueTypes[Index]);
+			for (int32 Component = 0; Component < NumComponents; ++Component)
+			{
+				Ar << Value[Component];
+			}
+		}
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool UFroggyInputReplaySubsystem::ReadRecording(const FString& Path, uint8 (&OutValueTypes)[uint8(EFroggyRecordedAction::Count)], TArray<FFroggyInputFrame>& OutFrames)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path)) return false;
+
+	FMemoryReader Ar(Bytes);
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint8 NumActions = 0;
+	Ar << Magic << Version << NumActions;
+	if (Magic != FileMagic || Version > FileVersion || NumActions > uint8(EFroggyRecordedAction::Count)) return false;
+
+	FMemory::Memzero(OutValueTypes);
+	for (uint8 Index = 0; Index < NumActions; ++Index)
+	{
+		Ar << OutValueTypes[Index];
+	}
+
+	uint32 NumFrames = 0;
+	Ar << NumFrames;
+
+	// Every frame is at least 5 bytes, so a bad count can't make us allocate more than the file could hold.
+	if (Ar.IsError() || NumFrames > uint32(Bytes.Num() / 5)) return false;
+
+	OutFrames.SetNum(NumFrames);
+	for (FFroggyInputFrame& Frame : OutFrames)
+	{
+		Ar << Frame.DeltaSeconds << Frame.ActiveMask;
+		for (uint8 Index = 0; Index < NumActions; ++Index)
+		{
+			Frame.Values[Index] = FVector3f::ZeroVector;
+			if (!(Frame.ActiveMask & (1 << Index))) continue;
+
+			const int32 NumComponents = FroggyInputReplay::GetNumComponents(OutValueTypes[Index]);
+			for (int32 Component = 0; Component < NumComponents; ++Component)
+			{
+				Ar << Frame.Values[Index][Component];
+			}
+		}
+	}
+
+	return !Ar.IsError();
+}
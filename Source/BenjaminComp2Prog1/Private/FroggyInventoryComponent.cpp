@@ -0,0 +1,263 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyInventoryComponent.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+void FFroggyInventoryStack::PreReplicatedRemove(const FFroggyInventoryList& InArraySerializer)
+{
+	if (UFroggyInventoryComponent* Owner = InArraySerializer.Owner)
+	{
+		Owner->TotalCount -= LastCount;
+		Owner->bIndexDirty = true;
+		Owner->PendingBroadcasts.Emplace(ItemId, 0);
+	}
+}
+
+void FFroggyInventoryStack::PostReplicatedAdd(const FFroggyInventoryList& InArraySerializer)
+{
+	if (UFroggyInventoryComponent* Owner = InArraySerializer.Owner)
+	{
+		Owner->TotalCount += Count;
+		Owner->bIndexDirty = true;
+		Owner->PendingBroadcasts.Emplace(ItemId, Count);
+	}
+	LastCount = Count;
+}
+
+void FFroggyInventoryStack::PostReplicatedChange(const FFroggyInventoryList& InArraySerializer)
+{
+	// Same stack, same place in the array - only the total moves, the index stays as it is.
+	if (UFroggyInventoryComponent* Owner = InArraySerializer.Owner)
+	{
+		Owner->TotalCount += Count - LastCount;
+		Owner->PendingBroadcasts.Emplace(ItemId, Count);
+	}
+	LastCount = Count;
+}
+
+void FFroggyInventoryList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (!Owner) return;
+
+	if (Owner->bIndexDirty)
+	{
+		Owner->RebuildIndex();
+	}
+
+	// Moved out before broadcasting, in case a handler does something that ends up back in here.
+	const TArray<TPair<FName, int32>> Broadcasts = MoveTemp(Owner->PendingBroadcasts);
+	for (const TPair<FName, int32>& Broadcast : Broadcasts)
+	{
+		Owner->OnInventoryChanged.Broadcast(Broadcast.Key, Broadcast.Value);
+	}
+}
+
+UFroggyInventoryComponent::UFroggyInventoryComponent()
+{
+	// Nothing to do per frame - everything happens when items are added or removed.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault(true);
+	Inventory.Owner = this;
+}
+
+void UFroggyInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly; // Nobody else needs to know what's in Froggy's pockets
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UFroggyInventoryComponent, Inventory, Params);
+}
+
+bool UFroggyInventoryComponent::CanModify() const
+{
+	const AActor* Owner = GetOwner();
+	return !Owner || Owner->HasAuthority();
+}
+
+void UFroggyInventoryComponent::MarkInventoryDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(UFroggyInventoryComponent, Inventory, this);
+}
+
+int32 UFroggyInventoryComponent::AddItem(FName ItemId, int32 Count)
+{
+	if (ItemId.IsNone() || Count <= 0 || !CanModify()) return GetCount(ItemId);
+
+	const int32 NewCount = AddToStack(ItemId, Count);
+	MarkInventoryDirty();
+
+	OnInventoryChanged.Broadcast(ItemId, NewCount);
+	return NewCount;
+}
+
+void UFroggyInventoryComponent::AddItems(TConstArrayView<FName> ItemIds)
+{
+	if (ItemIds.Num() == 0 || !CanModify()) return;
+
+	// No Reserve(Num + ItemIds.Num()) here: that's an exact fit, so every area pickup would reallocate. The arrays
+	// growing by themselves (with slack) allocate far less often.
+	for (const FName ItemId : ItemIds)
+	{
+		if (ItemId.IsNone()) continue;
+		OnInventoryChanged.Broadcast(ItemId, AddToStack(ItemId, 1));
+	}
+	MarkInventoryDirty();
+}
+
+int32 UFroggyInventoryComponent::AddToStack(FName ItemId, int32 Count)
+{
+	FFroggyInventoryStack* Stack;
+	if (const int32* Index = StackIndices.Find(ItemId))
+	{
+		Stack = &Inventory.Stacks[*Index];
+		Stack->Count += Count;
+	}
+	else
+	{
+		StackIndices.Add(ItemId, Inventory.Stacks.Num());
+		Stack = &Inventory.Stacks.AddDefaulted_GetRef();
+		Stack->ItemId = ItemId;
+		Stack->Count = Count;
+	}
+
+	TotalCount += Count;
+	Inventory.MarkItemDirty(*Stack);
+	return Stack->Count;
+}
+
+int32 UFroggyInventoryComponent::RemoveItem(FName ItemId, int32 Count)
+{
+	if (Count <= 0 || !CanModify()) return 0;
+
+	const int32 Removed = RemoveFromStack(ItemId, Count);
+	if (Removed > 0)
+	{
+		MarkInventoryDirty();
+		OnInventoryChanged.Broadcast(ItemId, GetCount(ItemId));
+	}
+	return Removed;
+}
+
+int32 UFroggyInventoryComponent::RemoveItems(TConstArrayView<FName> ItemIds)
+{
+	if (!CanModify()) return 0;
+
+	int32 Removed = 0;
+	for (const FName ItemId : ItemIds)
+	{
+		if (RemoveFromStack(ItemId, 1) > 0)
+		{
+			++Removed;
+			OnInventoryChanged.Broadcast(ItemId, GetCount(ItemId));
+		}
+	}
+
+	if (Removed > 0)
+	{
+		MarkInventoryDirty();
+	}
+	return Removed;
+}
+
+int32 UFroggyInventoryComponent::RemoveFromStack(FName ItemId, int32 Count)
+{
+	const int32* Index = StackIndices.Find(ItemId);
+	if (!Index) return 0;
+
+	const int32 StackIndex = *Index;
+	FFroggyInventoryStack& Stack = Inventory.Stacks[StackIndex];
+	const int32 Removed = FMath::Min(Count, Stack.Count);
+	Stack.Count -= Removed;
+	TotalCount -= Removed;
+
+	if (Stack.Count > 0)
+	{
+		Inventory.MarkItemDirty(Stack);
+	}
+	else
+	{
+		RemoveStackAt(StackIndex);
+	}
+	return Removed;
+}
+
+int32 UFroggyInventoryComponent::GetCount(FName ItemId) const
+{
+	const int32* Index = StackIndices.Find(ItemId);
+	return Index ? Inventory.Stacks[*Index].Count : 0;
+}
+
+void UFroggyInventoryComponent::Reserve(int32 NumStacks)
+{
+	Inventory.Stacks.Reserve(NumStacks);
+	StackIndices.Reserve(NumStacks);
+}
+
+void UFroggyInventoryComponent::Empty()
+{
+	if (!CanModify()) return;
+
+	// Keeps the memory, an inventory that was big once is likely to be big again.
+	Inventory.Stacks.Reset();
+	StackIndices.Reset();
+	TotalCount = 0;
+	Inventory.MarkArrayDirty();
+	MarkInventoryDirty();
+}
+
+void UFroggyInventoryComponent::RemoveStackAt(int32 Index)
+{
+	StackIndices.Remove(Inventory.Stacks[Index].ItemId);
+
+	// The stack that moves keeps its replication id, so clients only hear about the removal.
+	Inventory.Stacks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Inventory.Stacks.IsValidIndex(Index))
+	{
+		StackIndices.Add(Inventory.Stacks[Index].ItemId, Index);
+	}
+	Inventory.MarkArrayDirty();
+}
+
+void UFroggyInventoryComponent::RebuildIndex()
+{
+	bIndexDirty = false;
+
+	// The total is kept up to date by the replication callbacks, only the positions need redoing.
+	StackIndices.Reset();
+	for (int32 Index = 0; Index < Inventory.Stacks.Num(); ++Index)
+	{
+		StackIndices.Add(Inventory.Stacks[Index].ItemId, Index);
+	}
+}
+
+void UFroggyInventoryComponent::GetSnapshot(TArray<FName>& OutItemIds, TArray<int32>& OutCounts) const
+{
+	OutItemIds.Reset(Inventory.Stacks.Num());
+	OutCounts.Reset(Inventory.Stacks.Num());
+	for (const FFroggyInventoryStack& Stack : Inventory.Stacks)
+	{
+		OutItemIds.Add(Stack.ItemId);
+		OutCounts.Add(Stack.Count);
+	}
+}
+
+void UFroggyInventoryComponent::ApplySnapshot(TConstArrayView<FName> ItemIds, TConstArrayView<int32> Counts)
+{
+	if (!CanModify()) return;
+
+	Empty();
+	Reserve(ItemIds.Num());
+
+	const int32 NumStacks = FMath::Min(ItemIds.Num(), Counts.Num());
+	for (int32 Index = 0; Index < NumStacks; ++Index)
+	{
+		AddItem(ItemIds[Index], Counts[Index]);
+	}
+}
@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyMemoryReportCommandlet.h"
+#include "FroggyCharacter.h"
+#include "InteractableItem.h"
+#include "MyGameMode.h"
+#include "Components/LightComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "LightSceneProxy.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "PrimitiveSceneProxy.h"
+#include "RenderingThread.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+namespace FroggyMemoryReport
+{
+	/** What all objects of one class (inside the group's actors) cost together. */
+	struct FClassMemory
+	{
+		int32 Count = 0;
+		int64 ObjectBytes = 0;
+		int64 ProxyBytes = 0;
+		int64 PhysicsBytes = 0;
+		int32 NumProxies = 0;
+		int32 NumBodies = 0;
+
+		int64 GetTotalBytes() const { return ObjectBytes + ProxyBytes + PhysicsBytes; }
+
+		void Add(const FClassMemory& Other)
+		{
+			Count += Other.Count;
+			ObjectBytes += Other.ObjectBytes;
+			ProxyBytes += Other.ProxyBytes;
+			PhysicsBytes += Other.PhysicsBytes;
+			NumProxies += Other.NumProxies;
+			NumBodies += Other.NumBodies;
+		}
+	};
+
+	/** One kind of actor (items, Froggies) and everything inside them, by class. */
+	struct FGroupReport
+	{
+		const TCHAR* Name = nullptr;
+		int32 NumActors = 0;
+		TMap<const UClass*, FClassMemory> ByClass;
+		FClassMemory Total;
+
+		int64 GetBytesPerActor() const { return NumActors > 0 ? Total.GetTotalBytes() / NumActors : 0; }
+	};
+
+	static void MeasureObject(const UObject* Object, FClassMemory& Out)
+	{
+		++Out.Count;
+
+		// The object itself, plus whatever its arrays/maps/strings allocated (Max, not Num: slack is memory too).
+		// UObject::Serialize already counts the object's own size when the archive is counting memory, so that's
+		// all in GetMax - same number as "obj list" shows.
+		FArchiveCountMem CountMem(const_cast<UObject*>(Object));
+		Out.ObjectBytes += CountMem.GetMax();
+
+		if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Object))
+		{
+			if (Primitive->SceneProxy)
+			{
+				Out.ProxyBytes += Primitive->SceneProxy->GetMemoryFootprint();
+				++Out.NumProxies;
+			}
+			if (Primitive->IsPhysicsStateCreated())
+			{
+				FResourceSizeEx BodySize(EResourceSizeMode::Exclusive);
+				Primitive->BodyInstance.GetBodyInstanceResourceSizeEx(BodySize);
+				Out.PhysicsBytes += BodySize.GetTotalMemoryBytes();
+				++Out.NumBodies;
+			}
+		}
+		else if (const ULightComponent* Light = Cast<ULightComponent>(Object))
+		{
+			// Lights don't report a footprint - the proxy's size is the floor of what they cost the renderer.
+			if (Light->SceneProxy)
+			{
+				Out.ProxyBytes += sizeof(FLightSceneProxy);
+				++Out.NumProxies;
+			}
+		}
+	}
+
+	static void MeasureActor(const AActor* Actor, FGroupReport& Group)
+	{
+		++Group.NumActors;
+		MeasureObject(Actor, Group.ByClass.FindOrAdd(Actor->GetClass()));
+
+		// Components and everything else that lives inside the actor (anim instances, ...).
+		TArray<UObject*> Inner;
+		GetObjectsWithOuter(Actor, Inner, true);
+		for (const UObject* Object : Inner)
+		{
+			MeasureObject(Object, Group.ByClass.FindOrAdd(Object->GetClass()));
+		}
+	}
+
+	static void LogGroup(FGroupReport& Group, TArray<FString>& CsvLines)
+	{
+		for (const TPair<const UClass*, FClassMemory>& Pair : Group.ByClass)
+		{
+			Group.Total.Add(Pair.Value);
+		}
+
+		// Biggest first
+		Group.ByClass.ValueSort([](const FClassMemory& A, const FClassMemory& B) { return A.GetTotalBytes() > B.GetTotalBytes(); });
+
+		UE_LOG(LogTemp, Display, TEXT("🐸 %s: %d actors, %d objects, %lld bytes (%lld per actor)"),
+			Group.Name, Group.NumActors, Group.Total.Count, Group.Total.GetTotalBytes(), Group.GetBytesPerActor());
+		UE_LOG(LogTemp, Display, TEXT("    %-40s %8s %12s %12s %12s %12s"), TEXT("Class"), TEXT("Count"), TEXT("UObject"), TEXT("Proxy"), TEXT("Physics"), TEXT("Per actor"));
+
+		for (const TPair<const UClass*, FClassMemory>& Pair : Group.ByClass)
+		{
+			const FClassMemory& Memory = Pair.Value;
+			const int64 PerActor = Group.NumActors > 0 ? Memory.GetTotalBytes() / Group.NumActors : 0;
+
+			UE_LOG(LogTemp, Display, TEXT("    %-40s %8d %12lld %12lld %12lld %12lld"),
+				*Pair.Key->GetName(), Memory.Count, Memory.ObjectBytes, Memory.ProxyBytes, Memory.PhysicsBytes, PerActor);
+			CsvLines.Add(FString::Printf(TEXT("%s,%s,%d,%lld,%lld,%lld,%d,%d,%lld"), Group.Name, *Pair.Key->GetName(), Memory.Count,
+				Memory.ObjectBytes, Memory.ProxyBytes, Memory.PhysicsBytes, Memory.NumProxies, Memory.NumBodies, PerActor));
+		}
+	}
+
+	/** Logs one budget check. True if it's within the budget (or there's no budget). */
+	static bool CheckBudget(const TCHAR* What, int64 Bytes, int64 Budget)
+	{
+		if (Budget <= 0) return true;
+
+		if (Bytes > Budget)
+		{
+			UE_LOG(LogTemp, Error, TEXT("❌ %s: %lld bytes, over the budget of %lld"), What, Bytes, Budget);
+			return false;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("🐸 %s: %lld bytes, budget %lld"), What, Bytes, Budget);
+		return true;
+	}
+}
+
+UFroggyMemoryReportCommandlet::UFroggyMemoryReportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true; // Loads the uncooked map
+	LogToConsole = true;
+}
+
+int32 UFroggyMemoryReportCommandlet::Main(const FString& Params)
+{
+	using namespace FroggyMemoryReport;
+
+	FString MapName = DefaultMap;
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	if (!MapName.StartsWith(TEXT("/")))
+	{
+		MapName = TEXT("/Game/") + MapName;
+	}
+
+	FParse::Value(*Params, TEXT("MaxBytesPerItem="), MaxBytesPerItem);
+	FParse::Value(*Params, TEXT("MaxBytesPerFroggy="), MaxBytesPerFroggy);
+	FParse::Value(*Params, TEXT("MaxLevelBytes="), MaxLevelBytes);
+
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not load the map %s"), *MapName);
+		return 2;
+	}
+
+	// Bring the world up far enough that components register and get their render and physics state, like in game.
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.RequiresHitProxies(false)
+			.SetTransactional(false));
+	}
+	World->UpdateWorldComponents(true, false);
+	FlushRenderingCommands();
+
+	FGroupReport Items;
+	Items.Name = TEXT("Items");
+	FGroupReport Froggies;
+	Froggies.Name = TEXT("Froggies");
+
+	for (const ULevel* Level : World->GetLevels())
+	{
+		for (const AActor* Actor : Level->Actors)
+		{
+			if (!IsValid(Actor)) continue;
+
+			if (Actor->IsA<AInteractableItem>())
+			{
+				MeasureActor(Actor, Items);
+			}
+			else if (Actor->IsA<AFroggyCharacter>())
+			{
+				MeasureActor(Actor, Froggies);
+			}
+		}
+	}
+
+	// Froggy is usually spawned by the game mode, not placed - so put one in, the way the game mode would.
+	if (Froggies.NumActors == 0)
+	{
+		UClass* PawnClass = GetDefault<AMyGameMode>()->DefaultPawnClass;
+		if (!PawnClass || !PawnClass->IsChildOf<AFroggyCharacter>())
+		{
+			PawnClass = AFroggyCharacter::StaticClass();
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags = RF_Transient;
+		if (const AActor* Froggy = World->SpawnActor(PawnClass, nullptr, nullptr, SpawnParams))
+		{
+			FlushRenderingCommands();
+			MeasureActor(Froggy, Froggies);
+			UE_LOG(LogTemp, Display, TEXT("🐸 No Froggy placed in %s, measured a spawned %s instead"), *MapName, *PawnClass->GetName());
+		}
+	}
+
+	TArray<FString> CsvLines;
+	CsvLines.Add(TEXT("Group,Class,Count,UObjectBytes,ProxyBytes,PhysicsBytes,NumProxies,NumBodies,BytesPerActor"));
+	UE_LOG(LogTemp, Display, TEXT("🐸 Memory report for %s"), *MapName);
+	LogGroup(Items, CsvLines);
+	LogGroup(Froggies, CsvLines);
+
+	if (Items.Total.NumProxies + Froggies.Total.NumProxies == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No render proxies were created, so the Proxy column is 0. Run with -AllowCommandletRendering to include them."));
+	}
+
+	// What a level with a lot more items would cost, at today's per item cost
+	const int64 BytesPerItem = Items.GetBytesPerActor();
+	for (const int32 NumItems : { 10000, 100000 })
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 %d items would take about %.1f MB"), NumItems, double(BytesPerItem) * NumItems / (1024.0 * 1024.0));
+		CsvLines.Add(FString::Printf(TEXT("Extrapolated,%d items,%d,,,,,,%lld"), NumItems, NumItems, BytesPerItem * NumItems));
+	}
+
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Profiling/FroggyMemory")
+		/ FString::Printf(TEXT("%s-%s.csv"), *FPackageName::GetShortName(MapName), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
+	if (FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Wrote %s"), *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not write %s"), *CsvPath);
+	}
+
+	// Check every budget (not just up to the first one that fails), so one run shows everything that's over.
+	bool bWithinBudget = true;
+	bWithinBudget &= CheckBudget(TEXT("Per item"), BytesPerItem, MaxBytesPerItem);
+	bWithinBudget &= CheckBudget(TEXT("Per Froggy"), Froggies.GetBytesPerActor(), MaxBytesPerFroggy);
+	bWithinBudget &= CheckBudget(TEXT("Level total"), Items.Total.GetTotalBytes() + Froggies.Total.GetTotalBytes(), MaxLevelBytes);
+
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	return bWithinBudget ? 0 : 1;
+}
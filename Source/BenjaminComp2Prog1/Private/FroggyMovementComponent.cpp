@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyMovementComponent.h"
+#include "FroggyMovementSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+
+void UFroggyMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only registered, it's switched on by the subsystem once it fits (on the ground, AI controlled, on the server).
+	if (bUseLightweightMovement)
+	{
+		if (UFroggyMovementSubsystem* Batch = GetWorld()->GetSubsystem<UFroggyMovementSubsystem>())
+		{
+			Batch->RegisterComponent(this);
+		}
+	}
+}
+
+void UFroggyMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFroggyMovementSubsystem* Batch = GetWorld()->GetSubsystem<UFroggyMovementSubsystem>())
+	{
+		Batch->UnregisterComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UFroggyMovementComponent::CanUseLightweightMovement() const
+{
+	if (!bUseLightweightMovement || bLostFloor || !CharacterOwner || !UpdatedComponent) return false;
+	if (GetWorld()->GetTimeSeconds() < ResumeLightweightTime) return false;
+
+	// Server side AI only. Players - and the clients' copies of everybody - keep the full, predicted movement.
+	if (CharacterOwner->GetLocalRole() != ROLE_Authority || CharacterOwner->IsPlayerControlled()) return false;
+	if (const AController* OwnerController = CharacterOwner->GetController(); OwnerController && OwnerController->IsPlayerController()) return false;
+	if (CharacterOwner->IsPlayingRootMotion()) return false;
+
+	// Only starts from standing on something walkable. Falling etc. is left to the full movement until it lands.
+	return IsMovingOnGround() && (bLightweightActive || CurrentFloor.IsWalkableFloor());
+}
+
+void UFroggyMovementComponent::SetLightweightActive(bool bActive)
+{
+	if (bLightweightActive == bActive) return;
+	bLightweightActive = bActive;
+
+	// Forget any floor sample still on its way
+	FloorSampleHandle = FTraceHandle();
+
+	if (bActive)
+	{
+		// Start on the floor the full movement found last
+		SetFloor(CurrentFloor.HitResult);
+		LastFloorSampleLocation = UpdatedComponent->GetComponentLocation();
+		SetComponentTickEnabled(false);
+	}
+	else
+	{
+		if (bLostFloor)
+		{
+			bLostFloor = false;
+			ResumeLightweightTime = GetWorld()->GetTimeSeconds() + 1.0;
+		}
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UFroggyMovementComponent::PrepareLightweightMove(float DeltaTime)
+{
+	Move.DeltaTime = DeltaTime;
+	Move.Location = UpdatedComponent->GetComponentLocation();
+	Move.Rotation = UpdatedComponent->GetComponentRotation();
+	Move.Velocity = Velocity;
+
+	// AddMovementInput (Move(), behavior tree tasks, path following with bUseAccelerationForPaths) ...
+	Move.Input = ConsumeInputVector();
+
+	// ... or path following's RequestDirectMove, which is used up the same way the full movement does.
+	Move.RequestedVelocity = RequestedVelocity;
+	Move.bHasRequestedVelocity = bHasRequestedVelocity;
+	bHasRequestedVelocity = false;
+
+	Move.bOrientToMovement = bOrientRotationToMovement;
+	Move.MaxSpeed = GetMaxSpeed();
+	Move.MaxAcceleration = GetMaxAcceleration();
+	Move.BrakingDeceleration = GetMaxBrakingDeceleration();
+	Move.MaxYawStep = RotationRate.Yaw < 0.0f ? -1.0f : GetDeltaRotation(DeltaTime).Yaw;
+
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	Move.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	Move.Radius = Capsule->GetScaledCapsuleRadius();
+}
+
+void UFroggyMovementComponent::ComputeLightweightMove()
+{
+	const float DeltaTime = Move.DeltaTime;
+
+	FVector NewVelocity;
+	if (Move.bHasRequestedVelocity)
+	{
+		NewVelocity = Move.RequestedVelocity.GetClampedToMaxSize2D(Move.MaxSpeed);
+	}
+	else
+	{
+		const FVector Input = FVector(Move.Input.X, Move.Input.Y, 0.0f).GetClampedToMaxSize(1.0f);
+		if (!Input.IsNearlyZero())
+		{
+			// Accelerate towards where the input points, at most MaxAcceleration
+			const FVector TargetVelocity = Input * Move.MaxSpeed;
+			NewVelocity = Move.Velocity + (TargetVelocity - Move.Velocity).GetClampedToMaxSize(Move.MaxAcceleration * DeltaTime);
+		}
+		else
+		{
+			// No input: brake to a stop
+			const float Speed = Move.Velocity.Size2D();
+			const float NewSpeed = FMath::Max(Speed - Move.BrakingDeceleration * DeltaTime, 0.0f);
+			NewVelocity = Speed > UE_KINDA_SMALL_NUMBER ? Move.Velocity * (NewSpeed / Speed) : FVector::ZeroVector;
+		}
+	}
+	NewVelocity.Z = 0.0f;
+
+	FVector NewLocation = Move.Location + NewVelocity * DeltaTime;
+
+	// Stand on the floor plane. On a slope, the capsule's round bottom touches the floor off-center, so its center
+	// sits a bit higher than straight up from the plane: Radius / cos(slope) instead of Radius.
+	if (FloorNormal.Z > UE_KINDA_SMALL_NUMBER)
+	{
+		const FVector Offset = NewLocation - FloorPoint;
+		const float PlaneZ = FloorPoint.Z - (FloorNormal.X * Offset.X + FloorNormal.Y * Offset.Y) / FloorNormal.Z;
+		NewLocation.Z = PlaneZ + Move.HalfHeight - Move.Radius + Move.Radius / FloorNormal.Z + MIN_FLOOR_DIST;
+	}
+
+	FRotator NewRotation = Move.Rotation;
+	if (Move.bOrientToMovement && NewVelocity.SizeSquared2D() > UE_KINDA_SMALL_NUMBER)
+	{
+		const float TargetYaw = NewVelocity.Rotation().Yaw;
+		NewRotation.Yaw = Move.MaxYawStep < 0.0f ? TargetYaw : FMath::FixedTurn(Move.Rotation.Yaw, TargetYaw, Move.MaxYawStep);
+	}
+
+	Move.NewVelocity = NewVelocity;
+	Move.NewLocation = NewLocation;
+	Move.NewRotation = NewRotation;
+}
+
+void UFroggyMovementComponent::ApplyLightweightMove()
+{
+	Velocity = Move.NewVelocity;
+
+	// A Froggy standing around doesn't touch its components at all - that's most of a crowd most of the time.
+	if (Move.NewLocation.Equals(Move.Location, 0.01f) && Move.NewRotation.Equals(Move.Rotation, 0.01f)) return;
+
+	UpdatedComponent->SetWorldLocationAndRotation(Move.NewLocation, Move.NewRotation, false, nullptr, ETeleportType::None);
+	UpdateComponentVelocity();
+
+	if (FVector::DistSquared2D(Move.NewLocation, LastFloorSampleLocation) >= FMath::Square(GroundSampleDistance))
+	{
+		RequestFloorSample();
+	}
+}
+
+void UFroggyMovementComponent::RequestFloorSample()
+{
+	// One at a time. If one's still out, the next ApplyLightweightMove asks again.
+	if (FloorSampleHandle.IsValid()) return;
+
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const float TraceLength = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + MaxStepHeight;
+	const FVector End = Start - FVector(0.0f, 0.0f, TraceLength);
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(FroggyFloorSample), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	InitCollisionParams(Params, ResponseParams);
+
+	FTraceDelegate Delegate = FTraceDelegate::CreateUObject(this, &UFroggyMovementComponent::OnFloorSampleDone);
+	FloorSampleHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End,
+		UpdatedComponent->GetCollisionObjectType(), Params, ResponseParams, &Delegate);
+	LastFloorSampleLocation = Start;
+}
+
+void UFroggyMovementComponent::OnFloorSampleDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	// From before a switch to the full movement and back - not ours anymore.
+	if (!bLightweightActive || Handle != FloorSampleHandle) return;
+	FloorSampleHandle = FTraceHandle();
+
+	if (Datum.OutHits.Num() == 0 || !SetFloor(Datum.OutHits[0]))
+	{
+		bLostFloor = true;
+	}
+}
+
+bool UFroggyMovementComponent::SetFloor(const FHitResult& Hit)
+{
+	if (!Hit.bBlockingHit || !IsWalkable(Hit)) return false;
+
+	FloorPoint = Hit.ImpactPoint;
+	FloorNormal = Hit.ImpactNormal;
+	return true;
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyMovementSubsystem.h"
+#include "FroggyMovementComponent.h"
+#include "FroggyStats.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarFroggyLightweightMovement(
+	TEXT("Froggy.Movement.Lightweight"),
+	true,
+	TEXT("Froggies with bUseLightweightMovement move kinematically in one parallel batch. 0 = full character movement for everyone."));
+
+// Below this many, the ParallelFor isn't worth waking up the workers for.
+static constexpr int32 MinParallelBatch = 32;
+
+bool UFroggyMovementSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFroggyMovementSubsystem::Deinitialize()
+{
+	Components.Empty();
+	ActiveComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UFroggyMovementSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFroggyMovementSubsystem, STATGROUP_Tickables);
+}
+
+void UFroggyMovementSubsystem::RegisterComponent(UFroggyMovementComponent* Component)
+{
+	Components.AddUnique(Component);
+}
+
+void UFroggyMovementSubsystem::UnregisterComponent(UFroggyMovementComponent* Component)
+{
+	if (Components.RemoveSingleSwap(Component, EAllowShrinking::No) > 0)
+	{
+		// Just cleared, not removed: moving one Froggy can end another one's play (overlaps) in the middle of step 3.
+		const int32 ActiveIndex = ActiveComponents.Find(Component);
+		if (ActiveIndex != INDEX_NONE)
+		{
+			ActiveComponents[ActiveIndex] = nullptr;
+		}
+		Component->SetLightweightActive(false);
+	}
+}
+
+void UFroggyMovementSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_LightweightMovement);
+
+	// 1. Who's lightweight this frame, and their inputs.
+	const bool bEnabled = CVarFroggyLightweightMovement.GetValueOnGameThread();
+	ActiveComponents.Reset();
+	for (UFroggyMovementComponent* Component : Components)
+	{
+		const bool bLightweight = bEnabled && Component->CanUseLightweightMovement();
+		Component->SetLightweightActive(bLightweight);
+
+		if (bLightweight && DeltaTime > 0.0f)
+		{
+			Component->PrepareLightweightMove(DeltaTime);
+			ActiveComponents.Add(Component);
+		}
+	}
+
+	// 2. The actual movement math, all of them at once.
+	ParallelFor(ActiveComponents.Num(), [this](int32 Index)
+	{
+		ActiveComponents[Index]->ComputeLightweightMove();
+	}, ActiveComponents.Num() < MinParallelBatch ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// 3. Back on the game thread, move the ones that moved.
+	for (int32 Index = 0; Index < ActiveComponents.Num(); ++Index)
+	{
+		if (UFroggyMovementComponent* Component = ActiveComponents[Index])
+		{
+			Component->ApplyLightweightMove();
+		}
+	}
+
+	FROGGY_INC_COUNTER(STAT_Froggy_LightweightMovers, ActiveComponents.Num());
+}
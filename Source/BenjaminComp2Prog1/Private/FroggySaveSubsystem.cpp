@@ -0,0 +1,342 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggySaveSubsystem.h"
+#include "InteractableItem.h"
+#include "FroggyCharacter.h"
+#include "FroggyInventoryComponent.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Hash/CityHash.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const TCHAR* DefaultSlotName = TEXT("Froggy");
+
+static FAutoConsoleCommandWithWorldAndArgs GFroggySaveCommand(
+	TEXT("Froggy.Save"),
+	TEXT("Saves the changed items and Froggy to a slot. Usage: Froggy.Save [Slot]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UFroggySaveSubsystem* Saves = World ? UGameInstance::GetSubsystem<UFroggySaveSubsystem>(World->GetGameInstance()) : nullptr)
+		{
+			Saves->SaveGame(Args.Num() > 0 ? Args[0] : DefaultSlotName);
+		}
+	}));
+
+// How much of the world is actually loaded right now, vs. what the save remembers.
+static FAutoConsoleCommandWithWorld GFroggySaveStatsCommand(
+	TEXT("Froggy.Save.Stats"),
+	TEXT("Prints the changed items the save remembers, and how many items/levels are loaded right now."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UFroggySaveSubsystem* Saves = World ? UGameInstance::GetSubsystem<UFroggySaveSubsystem>(World->GetGameInstance()) : nullptr;
+		if (!Saves) return;
+
+		int32 NumLoadedLevels = 0;
+		for (const ULevel* Level : World->GetLevels())
+		{
+			NumLoadedLevels += Level && Level->bIsVisible ? 1 : 0;
+		}
+
+		const UItemSpatialHashSubsystem* ItemIndex = World->GetSubsystem<UItemSpatialHashSubsystem>();
+		UE_LOG(LogTemp, Display, TEXT("🐸 Save remembers %d changed items. Loaded: %d items in %d levels/cells%s"),
+			Saves->GetNumChangedItems(), ItemIndex ? ItemIndex->GetNumItems() : 0, NumLoadedLevels,
+			World->IsPartitionedWorld() ? TEXT(" (World Partition)") : TEXT(""));
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GFroggyLoadCommand(
+	TEXT("Froggy.Load"),
+	TEXT("Loads a slot and reopens its map. Usage: Froggy.Load [Slot]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UFroggySaveSubsystem* Saves = World ? UGameInstance::GetSubsystem<UFroggySaveSubsystem>(World->GetGameInstance()) : nullptr)
+		{
+			Saves->LoadGame(Args.Num() > 0 ? Args[0] : DefaultSlotName);
+		}
+	}));
+
+uint64 UFroggySaveSubsystem::MakeSaveId(const AActor* Actor)
+{
+	// Only actors that came out of a level package have a path that's the same every time the level is loaded.
+	if (!Actor || !Actor->HasAnyFlags(RF_WasLoaded)) return 0;
+
+	// With World Partition the actor lives in a generated cell package, which isn't the same in PIE and cooked games
+	// (and can change whenever the grid is rebuilt). Actor names are unique in a partitioned world though, so the
+	// world + actor name is stable. Without it, the full path - actors in different sublevels can share a name.
+	const UWorld* World = Actor->GetWorld();
+	const FString Path = World && World->IsPartitionedWorld()
+		? World->GetOutermost()->GetName() + TEXT(":") + Actor->GetName()
+		: Actor->GetPathName();
+
+	// PIE renames the level packages (UEDPIE_0_...), so strip that or PIE saves wouldn't match the packaged game.
+	const FTCHARToUTF8 Utf8Path(*UWorld::RemovePIEPrefix(Path));
+	const uint64 Id = CityHash64(Utf8Path.Get(), Utf8Path.Length());
+	return Id != 0 ? Id : 1; // 0 means "not saveable"
+}
+
+void UFroggySaveSubsystem::RecordItem(const AInteractableItem* Item, bool bRemoved)
+{
+	// Clients predicting a pickup don't get a say in what's saved.
+	if (!Item || !Item->HasAuthority() || Item->GetSaveId() == 0) return;
+
+	if (UFroggySaveSubsystem* Saves = UGameInstance::GetSubsystem<UFroggySaveSubsystem>(Item->GetGameInstance()))
+	{
+		Saves->RecordItemState(Item, bRemoved);
+	}
+}
+
+void UFroggySaveSubsystem::RecordItemState(const AInteractableItem* Item, bool bRemoved)
+{
+	const uint64 Id = Item->GetSaveId();
+	if (Id == 0) return;
+
+	EFroggySavedItemFlags Flags = EFroggySavedItemFlags::None;
+	if (bRemoved)
+	{
+		Flags |= Item->bIsAPickup ? EFroggySavedItemFlags::PickedUp : EFroggySavedItemFlags::Destroyed;
+	}
+	if (Item->IsLightOn())
+	{
+		Flags |= EFroggySavedItemFlags::LightOn;
+	}
+
+	// bLightOn can't be changed per placed item, so the class default is what the level has.
+	const AInteractableItem* Defaults = Item->GetClass()->GetDefaultObject<AInteractableItem>();
+	const bool bMatchesLevel = !bRemoved && Item->IsLightOn() == Defaults->IsLightOn();
+
+	if (bMatchesLevel)
+	{
+		Items.Remove(Id);
+	}
+	else
+	{
+		Items.Add(Id, Flags);
+	}
+}
+
+bool UFroggySaveSubsystem::FindItem(const AInteractableItem* Item, EFroggySavedItemFlags& OutFlags)
+{
+	if (!Item || Item->GetSaveId() == 0) return false;
+
+	const UFroggySaveSubsystem* Saves = UGameInstance::GetSubsystem<UFroggySaveSubsystem>(Item->GetGameInstance());
+	return Saves && Saves->FindItemState(Item, OutFlags);
+}
+
+bool UFroggySaveSubsystem::FindItemState(const AInteractableItem* Item, EFroggySavedItemFlags& OutFlags) const
+{
+	const EFroggySavedItemFlags* Flags = Items.Find(Item->GetSaveId());
+	if (!Flags) return false;
+
+	OutFlags = *Flags;
+	return true;
+}
+
+bool UFroggySaveSubsystem::ConsumeSavedPlayer(const UWorld* World, FFroggySavedPlayer& OutPlayer)
+{
+	if (!bHasSavedPlayer || !World || UWorld::RemovePIEPrefix(World->GetMapName()) != SavedPlayer.MapName) return false;
+
+	OutPlayer = SavedPlayer;
+	bHasSavedPlayer = false;
+	return true;
+}
+
+void UFroggySaveSubsystem::ResetState()
+{
+	Items.Empty();
+	bHasSavedPlayer = false;
+}
+
+FString UFroggySaveSubsystem::GetSlotPath(const FString& SlotName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".fsav");
+}
+
+bool UFroggySaveSubsystem::SaveGame(const FString& SlotName)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The first local player's Froggy. (Listen servers and standalone - a client doesn't save.)
+	FFroggySavedPlayer Player;
+	bool bHasPlayer = false;
+	UWorld* World = GetGameInstance()->GetWorld();
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (const AFroggyCharacter* Froggy = PlayerController ? Cast<AFroggyCharacter>(PlayerController->GetPawn()) : nullptr)
+	{
+		Player.MapName = UWorld::RemovePIEPrefix(World->GetMapName());
+		Player.Location = Froggy->GetActorLocation();
+		Player.Rotation = Froggy->GetActorRotation();
+		Player.bIsSitting = Froggy->GetIsSitting();
+		Froggy->GetInventory()->GetSnapshot(Player.InventoryIds, Player.InventoryCounts);
+		bHasPlayer = true;
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	WriteSnapshot(Writer, bHasPlayer ? &Player : nullptr);
+
+	const FString Path = GetSlotPath(SlotName);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Couldn't write save %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 Saved %d changed items (%d bytes) to %s in %.2f ms"),
+		GetNumChangedItems(), Bytes.Num(), *Path, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool UFroggySaveSubsystem::LoadGame(const FString& SlotName)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// One read for the whole file, then it's parsed from memory.
+	const FString Path = GetSlotPath(SlotName);
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ No save at %s"), *Path);
+		return false;
+	}
+
+	TMap<uint64, EFroggySavedItemFlags> LoadedItems;
+	FFroggySavedPlayer LoadedPlayer;
+	bool bLoadedPlayer = false;
+
+	FMemoryReader Reader(Bytes);
+	if (!ReadSnapshot(Reader, LoadedItems, LoadedPlayer, bLoadedPlayer))
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ %s is not a (compatible) Froggy save"), *Path);
+		return false;
+	}
+
+	Items = MoveTemp(LoadedItems);
+	SavedPlayer = MoveTemp(LoadedPlayer);
+	bHasSavedPlayer = bLoadedPlayer;
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 Loaded %d changed items (%d bytes) from %s in %.2f ms"),
+		GetNumChangedItems(), Bytes.Num(), *Path, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	// Reopen the map: every placed item picks up its state as it's loaded, before the first frame.
+	UWorld* World = GetGameInstance()->GetWorld();
+	const FString MapName = bHasSavedPlayer ? SavedPlayer.MapName : (World ? UWorld::RemovePIEPrefix(World->GetMapName()) : FString());
+	if (World && !MapName.IsEmpty())
+	{
+		UGameplayStatics::OpenLevel(World, FName(*MapName));
+	}
+	return true;
+}
+
+void UFroggySaveSubsystem::WriteSnapshot(FArchive& Ar, const FFroggySavedPlayer* Player) const
+{
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+	Ar << Magic << Version;
+
+	uint8 bHasPlayer = Player != nullptr;
+	Ar << bHasPlayer;
+	if (Player)
+	{
+		// Floats are plenty for a spawn spot, and half the size.
+		FString MapName = Player->MapName;
+		FVector3f Location(Player->Location);
+		FRotator3f Rotation(Player->Rotation);
+		uint8 bIsSitting = Player->bIsSitting;
+		Ar << MapName << Location << Rotation << bIsSitting;
+
+		// Same as the items below: the names in one block, then the counts in one bulk copy. (Saving doesn't change
+		// anything, the casts are just for the archive's non-const operators.)
+		uint32 NumStacks = Player->InventoryIds.Num();
+		Ar << NumStacks;
+		for (const FName& Id : Player->InventoryIds)
+		{
+			Ar << const_cast<FName&>(Id);
+		}
+		Ar.Serialize(const_cast<int32*>(Player->InventoryCounts.GetData()), NumStacks * sizeof(int32));
+	}
+
+	// The ids in one block, then the flags in another - 9 bytes per item, written in two bulk copies.
+	TArray<uint64> Ids;
+	TArray<EFroggySavedItemFlags> Flags;
+	Ids.Reserve(Items.Num());
+	Flags.Reserve(Items.Num());
+	for (const TPair<uint64, EFroggySavedItemFlags>& Item : Items)
+	{
+		Ids.Add(Item.Key);
+		Flags.Add(Item.Value);
+	}
+
+	uint32 NumItems = Ids.Num();
+	Ar << NumItems;
+	Ar.Serialize(Ids.GetData(), Ids.Num() * sizeof(uint64));
+	Ar.Serialize(Flags.GetData(), Flags.Num() * sizeof(EFroggySavedItemFlags));
+}
+
+bool UFroggySaveSubsystem::ReadSnapshot(FArchive& Ar, TMap<uint64, EFroggySavedItemFlags>& OutItems, FFroggySavedPlayer& OutPlayer, bool& bOutHasPlayer)
+{
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	Ar << Magic << Version;
+	if (Ar.IsError() || Magic != FileMagic || Version == 0 || Version > FileVersion) return false;
+
+	uint8 bHasPlayer = 0;
+	Ar << bHasPlayer;
+	bOutHasPlayer = bHasPlayer != 0;
+	if (bOutHasPlayer)
+	{
+		FVector3f Location;
+		FRotator3f Rotation;
+		uint8 bIsSitting = 0;
+		Ar << OutPlayer.MapName << Location << Rotation << bIsSitting;
+		OutPlayer.Location = FVector(Location);
+		OutPlayer.Rotation = FRotator(Rotation);
+		OutPlayer.bIsSitting = bIsSitting != 0;
+
+		if (Version >= 2)
+		{
+			uint32 NumStacks = 0;
+			Ar << NumStacks;
+
+			// Every stack is at least a name length and a count.
+			if (Ar.IsError() || int64(NumStacks) * (sizeof(int32) + sizeof(int32)) > Ar.TotalSize() - Ar.Tell()) return false;
+
+			OutPlayer.InventoryIds.SetNum(NumStacks);
+			for (FName& Id : OutPlayer.InventoryIds)
+			{
+				Ar << Id;
+			}
+			OutPlayer.InventoryCounts.SetNumUninitialized(NumStacks);
+			Ar.Serialize(OutPlayer.InventoryCounts.GetData(), NumStacks * sizeof(int32));
+		}
+	}
+
+	uint32 NumItems = 0;
+	Ar << NumItems;
+
+	// A broken file shouldn't make us allocate gigabytes.
+	if (Ar.IsError() || int64(NumItems) * (sizeof(uint64) + sizeof(EFroggySavedItemFlags)) > Ar.TotalSize() - Ar.Tell()) return false;
+
+	TArray<uint64> Ids;
+	TArray<EFroggySavedItemFlags> Flags;
+	Ids.SetNumUninitialized(NumItems);
+	Flags.SetNumUninitialized(NumItems);
+	Ar.Serialize(Ids.GetData(), NumItems * sizeof(uint64));
+	Ar.Serialize(Flags.GetData(), NumItems * sizeof(EFroggySavedItemFlags));
+
+	OutItems.Reserve(NumItems);
+	for (uint32 Index = 0; Index < NumItems; ++Index)
+	{
+		OutItems.Add(Ids[Index], Flags[Index]);
+	}
+
+	return !Ar.IsError();
+}
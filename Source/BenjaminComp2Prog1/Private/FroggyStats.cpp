@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyStats.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_STAT(STAT_Froggy_CheckForNearbyItems);
+DEFINE_STAT(STAT_Froggy_Interact);
+DEFINE_STAT(STAT_Froggy_PickupAnItem);
+DEFINE_STAT(STAT_Froggy_AnimGameThread);
+DEFINE_STAT(STAT_Froggy_AnimWorker);
+DEFINE_STAT(STAT_Froggy_CrowdUpdate);
+DEFINE_STAT(STAT_Froggy_LightweightMovement);
+DEFINE_STAT(STAT_Froggy_ItemInteract);
+DEFINE_STAT(STAT_Froggy_ItemPickup);
+DEFINE_STAT(STAT_Froggy_ItemBehaviors);
+DEFINE_STAT(STAT_Froggy_NearbyChecks);
+DEFINE_STAT(STAT_Froggy_NearbyChecksSkipped);
+DEFINE_STAT(STAT_Froggy_NearbyItemsFound);
+DEFINE_STAT(STAT_Froggy_Interactions);
+DEFINE_STAT(STAT_Froggy_Pickups);
+DEFINE_STAT(STAT_Froggy_Predictions);
+DEFINE_STAT(STAT_Froggy_Mispredictions);
+DEFINE_STAT(STAT_Froggy_CrowdTierChanges);
+DEFINE_STAT(STAT_Froggy_LightweightMovers);
+DEFINE_STAT(STAT_Froggy_AnimatedItems);
+DEFINE_STAT(STAT_Froggy_AudioVoices);
+DEFINE_STAT(STAT_Froggy_AudioCommands);
+DEFINE_STAT(STAT_Froggy_LightsActive);
+DEFINE_STAT(STAT_Froggy_LightsFading);
+DEFINE_STAT(STAT_Froggy_LightsCulled);
+
+UE_TRACE_CHANNEL_DEFINE(FroggyChannel);
+
+// Shows up as Froggy.Interaction in the trace. Cycle is in the same clock as the CPU events, so they line up.
+UE_TRACE_EVENT_BEGIN(Froggy, Interaction)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint8, Kind)
+	UE_TRACE_EVENT_FIELD(uint32, ItemId)
+	UE_TRACE_EVENT_FIELD(float, X)
+	UE_TRACE_EVENT_FIELD(float, Y)
+	UE_TRACE_EVENT_FIELD(float, Z)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, ItemName)
+UE_TRACE_EVENT_END()
+
+namespace FroggyTrace
+{
+	void OutputInteraction(EFroggyTraceInteraction Kind, const AActor* Item)
+	{
+		// Cheap early out, so we don't build the name string when nobody is recording this channel.
+		if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(FroggyChannel) || !Item) return;
+
+		const FString ItemName = Item->GetName();
+		const FVector Location = Item->GetActorLocation();
+
+		UE_TRACE_LOG(Froggy, Interaction, FroggyChannel)
+			<< Interaction.Cycle(FPlatformTime::Cycles64())
+			<< Interaction.Kind(uint8(Kind))
+			<< Interaction.ItemId(Item->GetUniqueID())
+			<< Interaction.X(float(Location.X))
+			<< Interaction.Y(float(Location.Y))
+			<< Interaction.Z(float(Location.Z))
+			<< Interaction.ItemName(*ItemName, ItemName.Len());
+	}
+}
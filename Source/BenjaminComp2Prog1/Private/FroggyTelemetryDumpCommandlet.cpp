@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyTelemetryDumpCommandlet.h"
+#include "FroggyTelemetrySubsystem.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+UFroggyTelemetryDumpCommandlet::UFroggyTelemetryDumpCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UFroggyTelemetryDumpCommandlet::Main(const FString& Params)
+{
+	FString FilePath;
+	if (!FParse::Value(*Params, TEXT("File="), FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Usage: -run=FroggyTelemetryDump -File=<path> [-Csv=<path>]"));
+		return 1;
+	}
+
+	FFroggyTelemetryFileHeader Header;
+	TArray<FFroggyTelemetryRecord> Records;
+	if (!UFroggyTelemetrySubsystem::ReadTelemetryFile(FilePath, Header, Records))
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ %s is missing or not a (version %d) telemetry file."), *FilePath, FFroggyTelemetryFileHeader::CurrentVersion);
+		return 1;
+	}
+
+	auto ToSeconds = [&Header](uint64 Cycles) { return double(Cycles - Header.StartCycles) / Header.CyclesPerSecond; };
+
+	int32 EventCounts[uint8(EFroggyTelemetryEvent::Count) + 1] = {};
+	for (const FFroggyTelemetryRecord& Record : Records)
+	{
+		++EventCounts[FMath::Min<uint8>(Record.Event, uint8(EFroggyTelemetryEvent::Count))];
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 %s: %d events over %.2f seconds"), *FilePath, Records.Num(), Records.Num() > 0 ? ToSeconds(Records.Last().Cycles) : 0.0);
+	for (uint8 Event = 0; Event <= uint8(EFroggyTelemetryEvent::Count); ++Event)
+	{
+		if (EventCounts[Event] > 0)
+		{
+			UE_LOG(LogTemp, Display, TEXT("    %-14s %d"), LexToString(EFroggyTelemetryEvent(Event)), EventCounts[Event]);
+		}
+	}
+
+	FString CsvPath;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvPath))
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(Records.Num() + 1);
+		Lines.Add(TEXT("Time,Event,ActorId,X,Y,Z,Value"));
+		for (const FFroggyTelemetryRecord& Record : Records)
+		{
+			Lines.Add(FString::Printf(TEXT("%.6f,%s,%u,%.1f,%.1f,%.1f,%.3f"), ToSeconds(Record.Cycles), LexToString(EFroggyTelemetryEvent(Record.Event)),
+				Record.ActorId, Record.X, Record.Y, Record.Z, Record.Value));
+		}
+
+		if (!FFileHelper::SaveStringArrayToFile(Lines, *CsvPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("❌ Could not write %s"), *CsvPath);
+			return 1;
+		}
+		UE_LOG(LogTemp, Display, TEXT("🐸 Wrote %s"), *CsvPath);
+	}
+
+	return 0;
+}
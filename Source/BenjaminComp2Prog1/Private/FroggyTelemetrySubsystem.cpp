@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FroggyTelemetrySubsystem.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include <atomic>
+
+const TCHAR* LexToString(EFroggyTelemetryEvent Event)
+{
+	switch (Event)
+	{
+	case EFroggyTelemetryEvent::Interact:		return TEXT("Interact");
+	case EFroggyTelemetryEvent::Pickup:			return TEXT("Pickup");
+	case EFroggyTelemetryEvent::LightToggle:	return TEXT("LightToggle");
+	case EFroggyTelemetryEvent::Sit:			return TEXT("Sit");
+	case EFroggyTelemetryEvent::HoldInteract:	return TEXT("HoldInteract");
+	default:									return TEXT("Unknown");
+	}
+}
+
+/**
+ * The background thread: wakes up every FlushInterval, takes everything out of the ring and appends it to the file.
+ * It's the only consumer of the ring, and the only one touching the file. Once the file is full, records are still
+ * taken out of the ring (so the game never notices), but only counted.
+ */
+class FFroggyTelemetryWriter : public FRunnable
+{
+public:
+	FFroggyTelemetryWriter(TSpscRingBuffer<FFroggyTelemetryRecord>& InRing, FArchive* InFile, float InFlushInterval, int64 InMaxRecords)
+		: Ring(InRing)
+		, File(InFile)
+		, FlushInterval(FMath::Max(InFlushInterval, 0.001f))
+		, MaxRecords(FMath::Max<int64>(InMaxRecords, 0))
+	{
+		Batch.Reserve(Ring.GetCapacity());
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStopRequested.load(std::memory_order_relaxed))
+		{
+			Flush();
+			FPlatformProcess::SleepNoStats(FlushInterval);
+		}
+
+		// Whatever came in while we were asked to stop.
+		Flush();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopRequested.store(true, std::memory_order_relaxed);
+	}
+
+	virtual void Exit() override
+	{
+		if (File)
+		{
+			File->Close();
+			delete File;
+			File = nullptr;
+		}
+	}
+
+	// Only read these once the thread is done.
+	int64 GetNumWritten() const { return NumWritten; }
+	int64 GetNumOverCap() const { return NumOverCap; }
+
+private:
+	void Flush()
+	{
+		Batch.Reset();
+		if (Ring.PopAll(Batch) == 0 || !File) return;
+
+		const int32 NumToWrite = int32(FMath::Min<int64>(Batch.Num(), MaxRecords - NumWritten));
+		NumOverCap += Batch.Num() - NumToWrite;
+		if (NumToWrite <= 0) return;
+
+		File->Serialize(Batch.GetData(), NumToWrite * sizeof(FFroggyTelemetryRecord));
+		File->Flush();
+		NumWritten += NumToWrite;
+	}
+
+	TSpscRingBuffer<FFroggyTelemetryRecord>& Ring;
+	FArchive* File = nullptr;
+	float FlushInterval = 0.05f;
+	int64 MaxRecords = 0;
+
+	TArray<FFroggyTelemetryRecord> Batch;
+	int64 NumWritten = 0;
+	int64 NumOverCap = 0;
+	std::atomic<bool> bStopRequested{ false };
+};
+
+bool UFroggyTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	// Off = no subsystem at all, Record() just finds nothing.
+	return Super::ShouldCreateSubsystem(Outer) && (bEnabled || FParse::Param(FCommandLine::Get(), TEXT("FroggyTelemetry")));
+#endif
+}
+
+void UFroggyTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+	DeleteOldFiles(Directory);
+
+	const FString Path = Directory / FString::Printf(TEXT("Froggy-%s.ftel"), *FDateTime::Now().ToString());
+	FArchive* File = IFileManager::Get().CreateFileWriter(*Path);
+	if (!File)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Could not create telemetry file %s - telemetry is off."), *Path);
+		return;
+	}
+
+	FFroggyTelemetryFileHeader Header;
+	Header.CyclesPerSecond = 1.0 / FPlatformTime::GetSecondsPerCycle64();
+	Header.StartCycles = FPlatformTime::Cycles64();
+	File->Serialize(&Header, sizeof(Header));
+
+	Ring = MakeUnique<TSpscRingBuffer<FFroggyTelemetryRecord>>(RingCapacity);
+	const int64 MaxRecords = (MaxFileBytes - int64(sizeof(Header))) / int64(sizeof(FFroggyTelemetryRecord));
+	Writer = MakeUnique<FFroggyTelemetryWriter>(*Ring, File, FlushInterval, MaxRecords);
+	WriterThread = FRunnableThread::Create(Writer.Get(), TEXT("FroggyTelemetryWriter"), 0, TPri_BelowNormal);
+
+	UE_LOG(LogTemp, Display, TEXT("🐸 Froggy telemetry is recording to %s"), *Path);
+}
+
+void UFroggyTelemetrySubsystem::Deinitialize()
+{
+	if (WriterThread)
+	{
+		// Kill(true) = Stop() + wait, so the writer gets to do its last flush and close the file.
+		WriterThread->Kill(true);
+		delete WriterThread;
+		WriterThread = nullptr;
+
+		UE_LOG(LogTemp, Display, TEXT("🐸 Froggy telemetry: %lld events written, %lld dropped, %lld over the file size cap."),
+			Writer->GetNumWritten(), NumDropped, Writer->GetNumOverCap());
+	}
+
+	Writer.Reset();
+	Ring.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFroggyTelemetrySubsystem::DeleteOldFiles(const FString& Directory) const
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Directory / TEXT("Froggy-*.ftel")), true, false);
+
+	// The names have the date in them (year first), so sorting by name is sorting by age.
+	Files.Sort();
+
+	const int32 NumToDelete = Files.Num() - FMath::Max(MaxFiles - 1, 0);
+	for (int32 Index = 0; Index < NumToDelete; ++Index)
+	{
+		IFileManager::Get().Delete(*(Directory / Files[Index]));
+	}
+}
+
+void UFroggyTelemetrySubsystem::Record(const AActor* Actor, EFroggyTelemetryEvent Event, float Value)
+{
+	if (!Actor) return;
+
+	if (UFroggyTelemetrySubsystem* Telemetry = UGameInstance::GetSubsystem<UFroggyTelemetrySubsystem>(Actor->GetGameInstance()))
+	{
+		Telemetry->RecordEvent(Actor, Event, Value);
+	}
+}
+
+void UFroggyTelemetrySubsystem::RecordEvent(const AActor* Actor, EFroggyTelemetryEvent Event, float Value)
+{
+	if (!Ring.IsValid() || !Actor) return;
+
+	const FVector Location = Actor->GetActorLocation();
+
+	FFroggyTelemetryRecord Record;
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.ActorId = Actor->GetUniqueID();
+	Record.Event = uint8(Event);
+	Record.X = float(Location.X);
+	Record.Y = float(Location.Y);
+	Record.Z = float(Location.Z);
+	Record.Value = Value;
+
+	if (Ring->TryPush(Record))
+	{
+		++NumRecorded;
+	}
+	else
+	{
+		++NumDropped;
+	}
+}
+
+bool UFroggyTelemetrySubsystem::ReadTelemetryFile(const FString& Path, FFroggyTelemetryFileHeader& OutHeader, TArray<FFroggyTelemetryRecord>& OutRecords)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path) || Bytes.Num() < int32(sizeof(FFroggyTelemetryFileHeader))) return false;
+
+	FMemory::Memcpy(&OutHeader, Bytes.GetData(), sizeof(OutHeader));
+	if (OutHeader.Magic != FFroggyTelemetryFileHeader::ExpectedMagic
+		|| OutHeader.Version != FFroggyTelemetryFileHeader::CurrentVersion
+		|| OutHeader.RecordSize != sizeof(FFroggyTelemetryRecord))
+	{
+		return false;
+	}
+
+	// A crash can leave half a record at the end - just ignore it.
+	const int32 NumRecords = (Bytes.Num() - sizeof(OutHeader)) / sizeof(FFroggyTelemetryRecord);
+	OutRecords.SetNumUninitialized(NumRecords);
+	FMemory::Memcpy(OutRecords.GetData(), Bytes.GetData() + sizeof(OutHeader), NumRecords * sizeof(FFroggyTelemetryRecord));
+	return true;
+}
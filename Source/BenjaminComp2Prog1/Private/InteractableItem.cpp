@@ -5,8 +5,25 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/PointLightComponent.h"
+#include "Engine/StaticMesh.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Sound/SoundBase.h"
 #include "Kismet/GameplayStatics.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "ItemPoolSubsystem.h"
+#include "LightweightItemSubsystem.h"
+#include "ItemLightBudgetSubsystem.h"
+#include "ItemBehaviorSubsystem.h"
+#include "InteractionAudioSubsystem.h"
+#include "ItemArchetypeSubsystem.h"
+#include "DeferredWorkSubsystem.h"
+#include "InteractionQuery.h"
+#include "InteractableItemArchetype.h"
+#include "FroggyStats.h"
+#include "FroggyTelemetrySubsystem.h"
+#include "FroggySaveSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 // Sets default values
 AInteractableItem::AInteractableItem()
@@ -23,23 +40,25 @@ AInteractableItem::AInteractableItem()
 	ObjectMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ObjectMesh"));
 	ObjectMesh->SetupAttachment(Root);
 	
-	// Using ConstructorHelper to help find the right mesh to set for our object, via the header "UObject/ConstructorHelpers.h".
+	// The engine Cube is always loaded anyway, so it costs nothing to have it as the default - items show up with a
+	// mesh (and collision) right away. An Archetype replaces it once its own mesh has loaded.
 	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("Static Mesh'/Engine/BasicShapes/Cube.Cube'"));
-    if (MeshAsset.Succeeded())
-    {
-    	UE_LOG(LogTemp, Warning, TEXT("👍 Loading object mesh %s!"), *MeshAsset.Object->GetName());
-	    ObjectMesh->SetStaticMesh(MeshAsset.Object);
-    	// Adjusting scale
-    	ObjectMesh->SetWorldScale3D(FVector(0.5f, 0.5f, 0.5f));
-    }
-    else
-    {
-	    UE_LOG(LogTemp, Warning, TEXT("❌ Failed to load object mesh"));
-    }
+	if (MeshAsset.Succeeded())
+	{
+		ObjectMesh->SetStaticMesh(MeshAsset.Object);
+	}
+	FallbackMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+	
+	// Adjusting scale (the archetype's MeshScale replaces this)
+	ObjectMesh->SetWorldScale3D(FVector(0.5f, 0.5f, 0.5f));
 
 	// Ensure correct relative transform of ObjectMesh
 	ObjectMesh->SetRelativeLocation(FVector(0, 0, 0));
 
+	// Overlaps are the InteractionSphere's job. Without this, every move of the mesh (see UItemBehaviorSubsystem)
+	// would run an overlap query for nothing.
+	ObjectMesh->SetGenerateOverlapEvents(false);
+
 	// Create CollisionSphere Component (to enable interactions)
 	InteractionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("InteractionSphere"));
 	InteractionSphere->SetupAttachment(Root);
@@ -47,6 +66,7 @@ AInteractableItem::AInteractableItem()
 	InteractionSphere->SetSphereRadius(80.0f);
 	InteractionSphere->SetGenerateOverlapEvents(true);
 	InteractionSphere->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+	InteractionSphere->SetCollisionResponseToChannel(ECC_Interactable, ECR_Overlap); // The only thing that answers Interactable queries
 
 	// Create PointLight Component
 	PointLight = CreateDefaultSubobject<UPointLightComponent>(TEXT("PointLight"));
@@ -55,70 +75,644 @@ AInteractableItem::AInteractableItem()
 	PointLight->SetVisibility(true);
 	PointLight->SetAttenuationRadius(100.0f);
 	PointLight->SetIntensity(200.0f);
+
+	// Multiplayer: the server owns item state and clients get a copy. Items sit still and rarely change, so they
+	// start dormant - the server doesn't look at them at all until something changes (WakeUpForReplication).
+	bReplicates = true;
+	SetReplicatingMovement(true); // Only matters when a pooled item comes back somewhere else
+	NetDormancy = DORM_Initial;
+}
+
+void AInteractableItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractableItem, bLightOn, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractableItem, bIsPooled, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractableItem, Archetype, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractableItem, InteractCount, Params);
+}
+
+void AInteractableItem::WakeUpForReplication()
+{
+	// FlushNetDormancy sends one update and lets the item go straight back to sleep - no need to set it awake.
+	if (HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		FlushNetDormancy();
+	}
 }
 
 // Called when the game starts or when spawned
 void AInteractableItem::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Spawned items (not placed in the level) replicate once so clients get them, then go dormant right away.
+	if (HasAuthority() && !IsNetStartupActor())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	// Let the spatial hash know we exist, so Froggy can find us without physics overlaps.
+	// (Items that were put to sleep by the pool before BeginPlay stay out until they're activated.)
+	if (bIsPooled) return;
 	
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->RegisterItem(this);
+	}
+
+	// The light budget decides when our light is actually visible from now on.
+	if (UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+	{
+		LightBudget->RegisterItem(this);
+	}
+
+	// Bobbing / spinning / pulsing, if we have any. (The archetype can change that once it's loaded.)
+	if (UItemBehaviorSubsystem* Behaviors = GetWorld()->GetSubsystem<UItemBehaviorSubsystem>())
+	{
+		Behaviors->RegisterItem(this);
+	}
+
+	// Mesh, light and sound from the archetype - right away if the level preloaded it, otherwise when it's loaded.
+	if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->RequestItemAssets(this);
+	}
 }
 
-void AInteractableItem::Interact()
+void AInteractableItem::PostInitializeComponents()
 {
-	UE_LOG(LogTemp, Warning, TEXT("%s was interacted with by %s"), *GetName(), *UGameplayStatics::GetPlayerPawn(this, 0)->GetName());
+	Super::PostInitializeComponents();
 
-	// Play sound if assigned
-	if (InteractionSound)
+	SaveId = UFroggySaveSubsystem::MakeSaveId(this);
+	bServerLightOn = bLightOn; // A placed item can start with the light off, and then no OnRep_LightOn says so
+
+	// Clients get the state from the server instead.
+	EFroggySavedItemFlags SavedFlags;
+	if (SaveId != 0 && GetNetMode() != NM_Client && UFroggySaveSubsystem::FindItem(this, SavedFlags))
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, InteractionSound, GetActorLocation());
+		ApplySavedState(SavedFlags);
 	}
+}
 
-	// Toggle the light, if enabled on the object
-	if (bToggleLight)
+void AInteractableItem::ApplySavedState(EFroggySavedItemFlags Flags)
+{
+	if (EnumHasAnyFlags(Flags, EFroggySavedItemFlags::Removed))
 	{
-		bLightOn = !bLightOn;
-		PointLight->SetVisibility(bLightOn);
-
-		if (bLightOn)
+		// Straight into the pool - BeginPlay then leaves it out of the spatial hash and light budget.
+		if (UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Light toggled: %s"), TEXT("ON"));
-			check(GEngine != nullptr);
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Lights going on."));
+			Pool->ReleaseItem(this);
 		}
 		else
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Light toggled: %s"), TEXT("OFF"));
-			check(GEngine != nullptr);
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Silver, TEXT("Lights going off."));
+			DeactivateForPool();
 		}
+		return;
+	}
+
+	// No SetLightOn: the light budget isn't tracking us yet, and it reads IsLightOn() when we register in BeginPlay.
+	bLightOn = EnumHasAnyFlags(Flags, EFroggySavedItemFlags::LightOn);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, bLightOn, this);
+	PointLight->SetVisibility(bLightOn);
+}
+
+void AInteractableItem::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+#if WITH_EDITOR
+	// Editor preview only: load synchronously so the item shows its archetype mesh in the viewport.
+	// In game the archetype subsystem does this async instead.
+	if (GetWorld() && !GetWorld()->IsGameWorld())
+	{
+		if (const UInteractableItemArchetype* LoadedArchetype = Archetype.LoadSynchronous())
+		{
+			LoadedArchetype->Mesh.LoadSynchronous();
+			ApplyArchetype(LoadedArchetype);
+		}
+		else if (!ObjectMesh->GetStaticMesh())
+		{
+			ObjectMesh->SetStaticMesh(FallbackMesh.LoadSynchronous());
+		}
+	}
+#endif
+}
+
+void AInteractableItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// EndPlay also runs on Destroy(), so this is the one place we need to leave the spatial hash.
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->UnregisterItem(this);
+	}
+
+	if (UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+	{
+		LightBudget->UnregisterItem(this);
+	}
+
+	if (UItemBehaviorSubsystem* Behaviors = GetWorld()->GetSubsystem<UItemBehaviorSubsystem>())
+	{
+		Behaviors->UnregisterItem(this);
+	}
+
+	if (ULightweightItemSubsystem* LightweightItems = GetWorld()->GetSubsystem<ULightweightItemSubsystem>())
+	{
+		LightweightItems->NotifyItemRemoved(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AInteractableItem::Interact()
+{
+	// Only the server changes item state. Clients ask it through AFroggyCharacter::Server_Interact.
+	if (bIsPooled || bIsClaimed || !HasAuthority()) return;
+
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_ItemInteract);
+	FROGGY_INC_COUNTER(STAT_Froggy_Interactions, 1);
+	FROGGY_TRACE_INTERACTION(EFroggyTraceInteraction::Interact, this);
+
+	// Goes to the telemetry file as a small record - no player lookup or string formatting on the game thread.
+	UFroggyTelemetrySubsystem::Record(this, EFroggyTelemetryEvent::Interact);
+
+	// Gameplay state changes right away: the light is on/off now, and a consumed item is gone now.
+	if (bToggleLight)
+	{
+		SetLightOn(!bLightOn);
+		UFroggyTelemetrySubsystem::Record(this, EFroggyTelemetryEvent::LightToggle, bLightOn ? 1.0f : 0.0f);
+	}
+
+	if (bDestroyOnInteract)
+	{
+		Claim();
+	}
+
+	// Clients play the effects when this replicates to them.
+	++InteractCount;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, InteractCount, this);
+	WakeUpForReplication();
+
+	// Everything the player only sees or hears can happen over the next frames. (See UDeferredWorkSubsystem)
+	UWorld* World = GetWorld();
+
+	// Play sound if assigned (and loaded). A dedicated server has nobody to play it to.
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		UDeferredWorkSubsystem::EnqueueOrRun(World, this, [this]() { PlayInteractionEffects(); });
+	}
+
+	if (bToggleLight)
+	{
+		UDeferredWorkSubsystem::EnqueueOrRun(World, this, [bTurnedOn = bLightOn]()
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("Light toggled: %s"), bTurnedOn ? TEXT("ON") : TEXT("OFF"));
+			check(GEngine != nullptr);
+			GEngine->AddOnScreenDebugMessage(-1, 5.0f, bTurnedOn ? FColor::Yellow : FColor::Silver, bTurnedOn ? TEXT("Lights going on.") : TEXT("Lights going off."));
+		});
 	}
 
 	// Destroy object if set to do so
 	if (bDestroyOnInteract)
 	{
-		FString objectName = this->GetName();
-		
-		check(GEngine != nullptr);
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, TEXT("Goodbye World! ...but remember me as " + objectName));
-		
-		Destroy();
+		UDeferredWorkSubsystem::EnqueueOrRun(World, this, [this]()
+		{
+			check(GEngine != nullptr);
+			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, TEXT("Goodbye World! ...but remember me as " + GetName()));
+
+			// Could have been pooled some other way in the meantime (e.g. the level cleaning up).
+			if (bIsClaimed && !bIsPooled)
+			{
+				RemoveFromPlay();
+			}
+		});
 	}
 }
 
 // Since we're adding pick-up functionality to an interactable item, this really should have been split into
 // two separate classes. One for Interactables and one for pickups, but this works ok for this tiny project. :3
-void AInteractableItem::PickupItem()
+bool AInteractableItem::PickupItem()
 {
-	if (!bIsAPickup) return;
-	
-	// TODO: If desired, run HUD code or other features. : )
+	// Sleeping pool items, and items somebody already grabbed, can't be picked up again. And only the server decides.
+	if (!bIsAPickup || bIsPooled || bIsClaimed || !HasAuthority()) return false;
+
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_ItemPickup);
+	FROGGY_INC_COUNTER(STAT_Froggy_Pickups, 1);
+	FROGGY_TRACE_INTERACTION(EFroggyTraceInteraction::Pickup, this);
+	UFroggyTelemetrySubsystem::Record(this, EFroggyTelemetryEvent::Pickup);
+
+	// It's ours now - the rest (message, back to the pool) is queued, so grabbing a pile of items doesn't hitch.
+	Claim();
 	
-	FString objectName = this->GetName();
-		
-	check(GEngine != nullptr);
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("I'm being picked up! ... remember me as " + objectName));
-		
-	Destroy();
+	// Whoever picked it up puts it in their inventory (see AFroggyCharacter::PickupAnItem), and a HUD can listen to
+	// UFroggyInventoryComponent::OnInventoryChanged - nothing else to do here.
+
+	UDeferredWorkSubsystem::EnqueueOrRun(GetWorld(), this, [this]()
+	{
+		check(GEngine != nullptr);
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("I'm being picked up! ... remember me as " + GetName()));
+
+		if (bIsClaimed && !bIsPooled)
+		{
+			RemoveFromPlay();
+		}
+	});
+
+	return true;
+}
+
+FName AInteractableItem::GetInventoryId() const
+{
+	// Only the path is needed, so this doesn't care whether the archetype is loaded.
+	return Archetype.IsNull() ? GetClass()->GetFName() : FName(*Archetype.GetAssetName());
+}
+
+bool AInteractableItem::PredictInteract()
+{
+	if (bIsPooled || bIsClaimed || HasAuthority()) return false;
+
+	// Same order as Interact(). Nothing here is marked dirty - a client has nothing to replicate.
+	if (bToggleLight)
+	{
+		SetLightOn(!bLightOn);
+	}
+
+	if (bDestroyOnInteract)
+	{
+		Claim();
+	}
+
+	++NumPredictedEffects;
+	PlayInteractionEffects();
+	return true;
+}
+
+bool AInteractableItem::PredictPickup()
+{
+	if (!bIsAPickup || bIsPooled || bIsClaimed || HasAuthority()) return false;
+
+	// Hidden and out of the spatial hash, so the next pickup check doesn't ask the server for it again.
+	Claim();
+	return true;
+}
+
+void AInteractableItem::RollbackPrediction(bool bWasPickup, bool bStillAvailable)
+{
+	if (!bWasPickup)
+	{
+		// The sound is already out there, but the echo from the server won't come now.
+		NumPredictedEffects = NumPredictedEffects > 0 ? NumPredictedEffects - 1 : 0;
+
+		// Back to what the server last told us. That's not always what we had before predicting: the server may have
+		// toggled it in the meantime, and it won't send that value again.
+		if (bToggleLight && bLightOn != bServerLightOn)
+		{
+			SetLightOn(bServerLightOn);
+		}
+	}
+
+	// Only bring the item back if the server still has it. If somebody else got it first, it stays gone - the
+	// server's hide/pool is on its way anyway.
+	if (bIsClaimed && !bIsPooled && bStillAvailable)
+	{
+		bIsClaimed = false;
+		SetActorHiddenInGame(false);
+
+		if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+		{
+			ItemIndex->RegisterItem(this);
+		}
+	}
+}
+
+void AInteractableItem::PlayInteractionEffects()
+{
+	USoundBase* Sound = InteractionSound.Get();
+	if (!Sound) return;
+
+	// Pooled, merged with the same sound nearby and kept within the voice budget - see UInteractionAudioSubsystem.
+	if (UInteractionAudioSubsystem* Audio = GetWorld()->GetSubsystem<UInteractionAudioSubsystem>())
+	{
+		Audio->PlaySound(Sound, GetActorLocation());
+	}
+	else
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, Sound, GetActorLocation());
+	}
+}
+
+void AInteractableItem::SetLightOn(bool bNewLightOn)
+{
+	if (bLightOn != bNewLightOn)
+	{
+		bLightOn = bNewLightOn;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, bLightOn, this);
+		WakeUpForReplication();
+		UFroggySaveSubsystem::RecordItem(this, false);
+	}
+
+	// With a light budget around, it fades the light in/out (if it makes the cut), so we don't touch visibility here.
+	if (!GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+	{
+		PointLight->SetVisibility(bLightOn);
+	}
+}
+
+void AInteractableItem::SetArchetype(TSoftObjectPtr<UInteractableItemArchetype> NewArchetype)
+{
+	if (Archetype != NewArchetype)
+	{
+		Archetype = NewArchetype;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, Archetype, this);
+		WakeUpForReplication();
+	}
+
+	if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->RequestItemAssets(this);
+	}
+}
+
+bool AInteractableItem::AreItemAssetsLoaded() const
+{
+	// A soft pointer that points at nothing counts as loaded - there's nothing to wait for.
+	auto IsReady = [](const auto& SoftPtr) { return SoftPtr.IsNull() || SoftPtr.IsValid(); };
+
+	if (!Archetype.IsNull())
+	{
+		const UInteractableItemArchetype* LoadedArchetype = Archetype.Get();
+		return LoadedArchetype && IsReady(LoadedArchetype->Mesh) && IsReady(LoadedArchetype->InteractionSound);
+	}
+
+	return (ObjectMesh->GetStaticMesh() || IsReady(FallbackMesh)) && IsReady(InteractionSound);
+}
+
+void AInteractableItem::GatherAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	if (!Archetype.IsNull())
+	{
+		// The archetype has to be loaded before we even know which mesh and sound it wants.
+		if (const UInteractableItemArchetype* LoadedArchetype = Archetype.Get())
+		{
+			OutPaths.Add(LoadedArchetype->Mesh.ToSoftObjectPath());
+			OutPaths.Add(LoadedArchetype->InteractionSound.ToSoftObjectPath());
+		}
+		else
+		{
+			OutPaths.Add(Archetype.ToSoftObjectPath());
+		}
+		return;
+	}
+
+	if (!ObjectMesh->GetStaticMesh())
+	{
+		OutPaths.Add(FallbackMesh.ToSoftObjectPath());
+	}
+	OutPaths.Add(InteractionSound.ToSoftObjectPath());
+}
+
+void AInteractableItem::ApplyLoadedAssets()
+{
+	if (const UInteractableItemArchetype* LoadedArchetype = Archetype.Get())
+	{
+		ApplyArchetype(LoadedArchetype);
+	}
+	else if (!ObjectMesh->GetStaticMesh())
+	{
+		ObjectMesh->SetStaticMesh(FallbackMesh.Get());
+	}
+}
+
+void AInteractableItem::ApplyArchetype(const UInteractableItemArchetype* LoadedArchetype)
+{
+	ObjectMesh->SetStaticMesh(LoadedArchetype->Mesh.Get());
+	ObjectMesh->SetRelativeScale3D(LoadedArchetype->MeshScale);
+
+	InteractionSphere->SetSphereRadius(LoadedArchetype->InteractionRadius);
+	InteractionSound = LoadedArchetype->InteractionSound;
+
+	PointLight->SetAttenuationRadius(LoadedArchetype->Light.AttenuationRadius);
+	PointLight->SetLightColor(LoadedArchetype->Light.Color);
+
+	// The light budget fades our intensity, so it needs to know the new full value instead of us setting it.
+	UWorld* World = GetWorld();
+	UItemLightBudgetSubsystem* LightBudget = World ? World->GetSubsystem<UItemLightBudgetSubsystem>() : nullptr;
+	if (LightBudget)
+	{
+		LightBudget->SetBaseIntensity(this, LoadedArchetype->Light.Intensity);
+	}
+	else
+	{
+		PointLight->SetIntensity(LoadedArchetype->Light.Intensity);
+	}
+
+	// After the intensity: without a light budget, the pulse scales the intensity it finds here.
+	Behavior = LoadedArchetype->Behavior;
+	if (UItemBehaviorSubsystem* Behaviors = World ? World->GetSubsystem<UItemBehaviorSubsystem>() : nullptr)
+	{
+		Behaviors->RegisterItem(this);
+	}
 }
 
+void AInteractableItem::RemoveFromPlay()
+{
+	// If we were promoted from a lightweight instance, make sure we don't turn back into one.
+	if (ULightweightItemSubsystem* LightweightItems = GetWorld()->GetSubsystem<ULightweightItemSubsystem>())
+	{
+		LightweightItems->NotifyItemRemoved(this);
+	}
+
+	// Pooling instead of Destroy() means no garbage for the GC, and no full actor spawn when an item comes back.
+	if (UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+	{
+		Pool->ReleaseItem(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AInteractableItem::Claim()
+{
+	bIsClaimed = true;
+
+	// Gone for good, as far as save games go. (Before the pool gets it and forgets our SaveId.)
+	UFroggySaveSubsystem::RecordItem(this, true);
+
+	// Out of the spatial hash: CheckForNearbyItems / the focus component can't find it again.
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->UnregisterItem(this);
+	}
+
+	// If we were promoted from a lightweight instance, make sure we don't turn back into one while we wait.
+	if (ULightweightItemSubsystem* LightweightItems = GetWorld()->GetSubsystem<ULightweightItemSubsystem>())
+	{
+		LightweightItems->NotifyItemRemoved(this);
+	}
+
+	SetActorHiddenInGame(true);
+	WakeUpForReplication(); // Clients hide it now too, not only once it's back in the pool
+}
+
+void AInteractableItem::DeactivateForPool()
+{
+	bIsPooled = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, bIsPooled, this);
+	WakeUpForReplication();
+
+	HideForPool();
+
+	// Reset the state back to the class defaults, so the next user of this item gets a fresh one.
+	// (InteractionSound plays on the audio subsystem's components, not ours, so there's nothing to stop.)
+	const AInteractableItem* Defaults = GetClass()->GetDefaultObject<AInteractableItem>();
+	if (Archetype != Defaults->Archetype)
+	{
+		// Drop the old archetype's mesh, so the class default (or fallback) gets applied on activation.
+		ObjectMesh->SetStaticMesh(Defaults->ObjectMesh->GetStaticMesh());
+		Archetype = Defaults->Archetype;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, Archetype, this);
+		WakeUpForReplication();
+	}
+	InteractionSound = Defaults->InteractionSound;
+	bDestroyOnInteract = Defaults->bDestroyOnInteract;
+	bToggleLight = Defaults->bToggleLight;
+	bIsAPickup = Defaults->bIsAPickup;
+	Behavior = Defaults->Behavior;
+	if (bLightOn != Defaults->bLightOn)
+	{
+		bLightOn = Defaults->bLightOn;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, bLightOn, this);
+		WakeUpForReplication();
+	}
+	LightweightHandle = INDEX_NONE;
+	SaveId = 0; // Whoever gets this actor from the pool next is a spawned item, not the one placed in the level
+}
+
+void AInteractableItem::HideForPool()
+{
+	bIsClaimed = false;
+
+	// Gone from the world as far as the player can tell: not drawn, not colliding, not findable.
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	if (UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+	{
+		LightBudget->UnregisterItem(this);
+	}
+	PointLight->SetVisibility(false);
+
+	// Before DeactivateForPool resets the item, so the mesh and light get their rest pose back first.
+	if (UItemBehaviorSubsystem* Behaviors = GetWorld()->GetSubsystem<UItemBehaviorSubsystem>())
+	{
+		Behaviors->UnregisterItem(this);
+	}
+
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->UnregisterItem(this);
+	}
+}
+
+void AInteractableItem::ActivateFromPool(const FTransform& Transform)
+{
+	bIsPooled = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AInteractableItem, bIsPooled, this);
+	WakeUpForReplication();
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->RegisterItem(this);
+	}
+
+	if (UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+	{
+		LightBudget->RegisterItem(this);
+	}
+	else
+	{
+		PointLight->SetVisibility(bLightOn);
+	}
+
+	if (UItemBehaviorSubsystem* Behaviors = GetWorld()->GetSubsystem<UItemBehaviorSubsystem>())
+	{
+		Behaviors->RegisterItem(this);
+	}
+
+	// The archetype may have been reset (or changed) while we were sleeping.
+	if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->RequestItemAssets(this);
+	}
+}
+
+void AInteractableItem::OnRep_LightOn()
+{
+	// bLightOn already has the server's value - this just makes the light match it.
+	bServerLightOn = bLightOn;
+	SetLightOn(bLightOn);
+}
+
+void AInteractableItem::OnRep_IsPooled()
+{
+	// Mirror what the server's pool did, so the client's copy also leaves (or rejoins) the spatial hash & light budget.
+	// Only the local part: the reset archetype and light come from the server like any other change.
+	if (bIsPooled)
+	{
+		HideForPool();
+	}
+	else
+	{
+		ActivateFromPool(GetActorTransform());
+	}
+}
+
+void AInteractableItem::OnRep_Archetype()
+{
+	if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->RequestItemAssets(this);
+	}
+}
+
+void AInteractableItem::OnRep_InteractCount(uint8 OldCount)
+{
+	// The first update of a new (or newly relevant again) item brings the whole count - those interactions
+	// happened before we could see the item, so there's nothing to play for them.
+	if (!HasActorBegunPlay()) return;
+
+	// Several interactions can arrive in one update. uint8 math, so it's right across the wrap at 255 too.
+	const uint8 NumNew = InteractCount - OldCount;
+
+	// Our own predicted interactions among them - we played those already.
+	const uint8 NumOurs = FMath::Min(NumNew, NumPredictedEffects);
+	NumPredictedEffects -= NumOurs;
+
+	// Somebody else's. One sound for all of them, the audio subsystem would merge them anyway.
+	if (NumNew > NumOurs)
+	{
+		PlayInteractionEffects();
+	}
+}
+
+void AInteractableItem::OnRep_ReplicatedMovement()
+{
+	Super::OnRep_ReplicatedMovement();
+
+	// A pooled item came back somewhere else - the spatial hash needs the new spot.
+	if (UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>())
+	{
+		ItemIndex->UpdateItem(this);
+	}
+}
@@ -0,0 +1,13 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractableItemArchetype.h"
+
+const FPrimaryAssetType UInteractableItemArchetype::PrimaryAssetType = TEXT("InteractableItemArchetype");
+const FName UInteractableItemArchetype::GameBundle = TEXT("Game");
+
+FPrimaryAssetId UInteractableItemArchetype::GetPrimaryAssetId() const
+{
+	// Type + asset name, e.g. "InteractableItemArchetype:DA_Lamp". Has to match the type in AssetManagerSettings.
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionAudioSubsystem.h"
+#include "FroggyStats.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Sound/SoundBase.h"
+
+static FAutoConsoleCommandWithWorld GFroggyAudioStatsCommand(
+	TEXT("Froggy.Audio.Stats"),
+	TEXT("Prints the interaction audio voice counts and how many requests were merged or dropped."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UInteractionAudioSubsystem* Audio = World ? World->GetSubsystem<UInteractionAudioSubsystem>() : nullptr)
+		{
+			const FInteractionAudioStats Stats = Audio->GetStats();
+			UE_LOG(LogTemp, Display, TEXT("🐸 Interaction audio: %d voices, %d pooled components, %d requested, %d played, %d coalesced, %d dropped, %d audio commands last frame"),
+				Stats.NumVoices, Stats.NumPooled, Stats.NumRequested, Stats.NumPlayed, Stats.NumCoalesced, Stats.NumDropped, Stats.NumCommandsLastFrame);
+		}
+	}));
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs GFroggyAudioBurstCommand(
+	TEXT("Froggy.Audio.Burst"),
+	TEXT("Requests N interaction sounds in one frame around the player, to check coalescing and the voice budgets. Usage: Froggy.Audio.Burst N SoundPath"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UInteractionAudioSubsystem* Audio = World ? World->GetSubsystem<UInteractionAudioSubsystem>() : nullptr;
+		USoundBase* Sound = Args.Num() > 1 ? LoadObject<USoundBase>(nullptr, *Args[1]) : nullptr;
+		if (!Audio || !Sound)
+		{
+			UE_LOG(LogTemp, Error, TEXT("❌ Usage: Froggy.Audio.Burst N SoundPath (e.g. /Game/Audio/S_Pickup.S_Pickup)"));
+			return;
+		}
+
+		FVector Center = FVector::ZeroVector;
+		if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+		{
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Center, Rotation);
+		}
+
+		// Fixed seed, so every burst of the same size hits the budgets the same way.
+		FRandomStream Random(1337);
+		const int32 Count = FCString::Atoi(*Args[0]);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Audio->PlaySound(Sound, Center + FVector(Random.FRandRange(-2000.0f, 2000.0f), Random.FRandRange(-2000.0f, 2000.0f), 0.0f));
+		}
+	}));
+#endif
+
+bool UInteractionAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInteractionAudioSubsystem::Deinitialize()
+{
+	// The components go away with the pool actor, together with the world.
+	Voices.Empty();
+	Requests.Empty();
+	Merged.Empty();
+	FreeComponents.Empty();
+	Pool.Empty();
+	PoolActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+TStatId UInteractionAudioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionAudioSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractionAudioSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	UInteractionAudioSubsystem* This = CastChecked<UInteractionAudioSubsystem>(InThis);
+	for (FSoundRequest& Request : This->Requests)
+	{
+		Collector.AddReferencedObject(Request.Sound, This);
+	}
+	for (FVoice& Voice : This->Voices)
+	{
+		Collector.AddReferencedObject(Voice.Sound, This);
+	}
+}
+
+void UInteractionAudioSubsystem::PlaySound(USoundBase* Sound, const FVector& Location)
+{
+	// Nobody to hear it on a dedicated server.
+	if (!Sound || GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	++Stats.NumRequested;
+
+	FSoundRequest& Request = Requests.AddDefaulted_GetRef();
+	Request.Sound = Sound;
+	Request.Location = Location;
+}
+
+void UInteractionAudioSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	NumCommands = 0;
+
+	// Voices that are done hand their component back. Sounds stop on their own, so there's nothing to tell the audio thread.
+	for (int32 Index = Voices.Num() - 1; Index >= 0; --Index)
+	{
+		const FVoice& Voice = Voices[Index];
+		if (Now < Voice.EndTime && IsValid(Voice.Component)) continue;
+
+		if (IsValid(Voice.Component))
+		{
+			FreeComponents.Add(Voice.Component);
+		}
+		Voices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+
+	FlushRequests();
+
+	Stats.NumVoices = Voices.Num();
+	Stats.NumPooled = Pool.Num();
+	Stats.NumCommandsLastFrame = NumCommands;
+
+	FROGGY_INC_COUNTER(STAT_Froggy_AudioVoices, Voices.Num());
+	FROGGY_INC_COUNTER(STAT_Froggy_AudioCommands, NumCommands);
+}
+
+void UInteractionAudioSubsystem::FlushRequests()
+{
+	if (Requests.Num() == 0) return;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	FVector ListenerLocation = FVector::ZeroVector;
+	if (const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		FVector FrontDirection;
+		FVector RightDirection;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, FrontDirection, RightDirection);
+	}
+
+	// 1. Merge what's close together: into a voice that just started, or into another request from this frame.
+	const float CoalesceRadiusSquared = FMath::Square(CoalesceRadius);
+	Merged.Reset();
+	for (const FSoundRequest& Request : Requests)
+	{
+		if (CoalesceWithVoice(Request, Now))
+		{
+			++Stats.NumCoalesced;
+			continue;
+		}
+
+		FSoundRequest* Existing = Merged.FindByPredicate([&Request, CoalesceRadiusSquared](const FSoundRequest& Other)
+		{
+			return Other.Sound == Request.Sound && FVector::DistSquared(Other.Location, Request.Location) <= CoalesceRadiusSquared;
+		});
+		if (Existing)
+		{
+			++Existing->Count;
+			++Stats.NumCoalesced;
+			continue;
+		}
+
+		FSoundRequest& New = Merged.Add_GetRef(Request);
+		New.DistanceSquared = FVector::DistSquared(Request.Location, ListenerLocation);
+	}
+	Requests.Reset();
+
+	// 2. + 3. Closest first, as long as the budgets allow.
+	Merged.Sort([](const FSoundRequest& A, const FSoundRequest& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+	for (const FSoundRequest& Request : Merged)
+	{
+		int32 NumSoundVoices = 0;
+		for (const FVoice& Voice : Voices)
+		{
+			NumSoundVoices += Voice.Sound == Request.Sound ? 1 : 0;
+		}
+
+		if (Voices.Num() >= MaxVoices || NumSoundVoices >= MaxVoicesPerSound)
+		{
+			Stats.NumDropped += Request.Count;
+			continue;
+		}
+
+		StartVoice(Request, Now);
+	}
+}
+
+bool UInteractionAudioSubsystem::CoalesceWithVoice(const FSoundRequest& Request, double Now)
+{
+	const float CoalesceRadiusSquared = FMath::Square(CoalesceRadius);
+	for (FVoice& Voice : Voices)
+	{
+		if (Voice.Sound != Request.Sound || Now - Voice.StartTime > CoalesceWindow) continue;
+		if (FVector::DistSquared(Voice.Location, Request.Location) > CoalesceRadiusSquared) continue;
+
+		++Voice.Count;
+		Voice.Component->SetVolumeMultiplier(GetVolumeMultiplier(Voice.Count));
+		++NumCommands;
+		return true;
+	}
+	return false;
+}
+
+void UInteractionAudioSubsystem::StartVoice(const FSoundRequest& Request, double Now)
+{
+	UAudioComponent* Component = GetFreeComponent();
+	if (!Component)
+	{
+		Stats.NumDropped += Request.Count;
+		return;
+	}
+
+	// Only Play() goes to the audio thread - the rest is just set on the component for it to pick up.
+	Component->SetWorldLocation(Request.Location);
+	Component->SetSound(Request.Sound);
+	Component->SetVolumeMultiplier(GetVolumeMultiplier(Request.Count));
+	Component->Play();
+	++NumCommands;
+
+	// Counted by length rather than asking the audio device, so it's the same without one.
+	float Duration = Request.Sound->GetDuration();
+	if (Duration <= 0.0f || Duration > MaxVoiceDuration)
+	{
+		Duration = MaxVoiceDuration;
+	}
+
+	FVoice& Voice = Voices.AddDefaulted_GetRef();
+	Voice.Component = Component;
+	Voice.Sound = Request.Sound;
+	Voice.Location = Request.Location;
+	Voice.StartTime = Now;
+	Voice.EndTime = Now + Duration;
+	Voice.Count = Request.Count;
+
+	++Stats.NumPlayed;
+}
+
+UAudioComponent* UInteractionAudioSubsystem::GetFreeComponent()
+{
+	if (FreeComponents.Num() > 0)
+	{
+		return FreeComponents.Pop(EAllowShrinking::No);
+	}
+
+	// Never more components than voices can play at once.
+	if (Pool.Num() >= MaxVoices) return nullptr;
+
+	if (!PoolActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("InteractionAudioPool");
+		SpawnParams.ObjectFlags |= RF_Transient;
+		PoolActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// Not attached to anything, so every component goes wherever its sound is.
+	UAudioComponent* Component = NewObject<UAudioComponent>(PoolActor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->bAllowSpatialization = true;
+	Component->RegisterComponent();
+
+	Pool.Add(Component);
+	return Component;
+}
+
+float UInteractionAudioSubsystem::GetVolumeMultiplier(int32 Count) const
+{
+	return FMath::Min(1.0f + (Count - 1) * CoalescedVolumeStep, MaxCoalescedVolume);
+}
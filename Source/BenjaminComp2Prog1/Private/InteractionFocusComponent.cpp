@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionFocusComponent.h"
+#include "InteractableItem.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "InteractionQuery.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+UInteractionFocusComponent::UInteractionFocusComponent()
+{
+	// Doesn't need to run every frame - a focus that's 50 ms old is fine, and SelectBestTarget refreshes on demand.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = UpdateInterval;
+}
+
+void UInteractionFocusComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SetComponentTickInterval(UpdateInterval);
+
+	UpdateCandidates();
+	UpdateFocus();
+}
+
+void UInteractionFocusComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Candidates.Empty();
+	CandidateX.Empty();
+	CandidateY.Empty();
+	CandidateZ.Empty();
+	CandidateIndices.Empty();
+	FocusedItem.Reset();
+	bHasCandidates = false;
+	AsyncQueryHandle = FTraceHandle();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AInteractableItem* UInteractionFocusComponent::SelectBestTarget()
+{
+	UpdateCandidates();
+	UpdateFocus();
+
+	return FocusedItem.Get();
+}
+
+void UInteractionFocusComponent::UpdateCandidates()
+{
+	const AActor* Owner = GetOwner();
+	UItemSpatialHashSubsystem* ItemIndex = GetWorld() ? GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>() : nullptr;
+	if (!Owner || !ItemIndex) return;
+
+	// Async: one query in flight at a time, and until its answer is in (OnAsyncQueryDone) there's nothing to compare
+	// against - the candidates still are what the last answer said.
+	const bool bAsync = InteractionQuery::GetMode() == EInteractionQueryMode::AsyncPhysics;
+	if (bAsync && AsyncQueryHandle.IsValid() && GetWorld()->IsTraceHandleValid(AsyncQueryHandle, true)) return;
+
+	const FVector Location = Owner->GetActorLocation();
+	const uint32 Revision = ItemIndex->GetRevision();
+
+	// Same spot, same radius, no item added or moved: the same items are in range as last time.
+	// (Items leaving through the pool are caught in UpdateFocus, they don't have to wait for this.)
+	if (bHasCandidates && Location.Equals(LastUpdateLocation, 1.0f) && Revision == LastUpdateRevision && FocusRadius == LastUpdateRadius) return;
+
+	LastUpdateLocation = Location;
+	LastUpdateRevision = Revision;
+	LastUpdateRadius = FocusRadius;
+	bHasCandidates = true;
+
+	TArray<AInteractableItem*> InRange;
+	switch (InteractionQuery::GetMode())
+	{
+	case EInteractionQueryMode::SpatialHash:
+		ItemIndex->QueryItemsInRadius(Location, FocusRadius, InRange);
+		break;
+
+	case EInteractionQueryMode::SyncPhysics:
+		InteractionQuery::OverlapItems(GetWorld(), Location, FocusRadius, Owner, InRange);
+		break;
+
+	case EInteractionQueryMode::AsyncPhysics:
+		// The answer comes next frame, in OnAsyncQueryDone.
+		AsyncQueryHandle = InteractionQuery::AsyncOverlapItems(GetWorld(), Location, FocusRadius, Owner,
+			FOverlapDelegate::CreateUObject(this, &UInteractionFocusComponent::OnAsyncQueryDone));
+		return;
+	}
+
+	SetCandidates(InRange);
+}
+
+void UInteractionFocusComponent::OnAsyncQueryDone(const FTraceHandle& Handle, FOverlapDatum& Datum)
+{
+	AsyncQueryHandle = FTraceHandle();
+
+	TArray<AInteractableItem*> InRange;
+	InteractionQuery::GetOverlapResultItems(Datum, LastUpdateRadius, InRange);
+	SetCandidates(InRange);
+}
+
+void UInteractionFocusComponent::SetCandidates(const TArray<AInteractableItem*>& InRange)
+{
+	// Mark who's still here, add the newcomers...
+	TBitArray<> StillInRange(false, Candidates.Num());
+	for (AInteractableItem* Item : InRange)
+	{
+		const FVector ItemLocation = Item->GetActorLocation();
+
+		if (const int32* Index = CandidateIndices.Find(Item))
+		{
+			StillInRange[*Index] = true;
+
+			// A pooled item can come back somewhere else, so keep the position fresh.
+			CandidateX[*Index] = float(ItemLocation.X);
+			CandidateY[*Index] = float(ItemLocation.Y);
+			CandidateZ[*Index] = float(ItemLocation.Z);
+		}
+		else
+		{
+			AddCandidate(Item, ItemLocation);
+			StillInRange.Add(true);
+		}
+	}
+
+	// ...and drop the ones that left. Going backwards, so the swapped-in last element has already been checked.
+	for (int32 Index = Candidates.Num() - 1; Index >= 0; --Index)
+	{
+		if (!StillInRange[Index])
+		{
+			RemoveCandidateAt(Index);
+		}
+	}
+}
+
+void UInteractionFocusComponent::UpdateFocus()
+{
+	FocusedItem.Reset();
+
+	const AActor* Owner = GetOwner();
+	const int32 NumCandidates = Candidates.Num();
+	if (!Owner || NumCandidates == 0) return;
+
+	const FVector Origin = Owner->GetActorLocation();
+	const FVector Forward = Owner->GetActorForwardVector();
+	const float InvRadius = 1.0f / FMath::Max(FocusRadius, 1.0f);
+
+	Scores.SetNumUninitialized(NumCandidates, EAllowShrinking::No);
+
+	// Four candidates per step. Every line here is the vector version of the scalar tail loop below.
+	const VectorRegister4Float OriginX = VectorSetFloat1(float(Origin.X));
+	const VectorRegister4Float OriginY = VectorSetFloat1(float(Origin.Y));
+	const VectorRegister4Float OriginZ = VectorSetFloat1(float(Origin.Z));
+	const VectorRegister4Float ForwardX = VectorSetFloat1(float(Forward.X));
+	const VectorRegister4Float ForwardY = VectorSetFloat1(float(Forward.Y));
+	const VectorRegister4Float ForwardZ = VectorSetFloat1(float(Forward.Z));
+	const VectorRegister4Float DistanceW = VectorSetFloat1(DistanceWeight);
+	const VectorRegister4Float FacingW = VectorSetFloat1(FacingWeight);
+	const VectorRegister4Float InvRadiusV = VectorSetFloat1(InvRadius);
+	const VectorRegister4Float MinDistanceSquared = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+
+	int32 Index = 0;
+	for (; Index + 4 <= NumCandidates; Index += 4)
+	{
+		const VectorRegister4Float DX = VectorSubtract(VectorLoad(&CandidateX[Index]), OriginX);
+		const VectorRegister4Float DY = VectorSubtract(VectorLoad(&CandidateY[Index]), OriginY);
+		const VectorRegister4Float DZ = VectorSubtract(VectorLoad(&CandidateZ[Index]), OriginZ);
+
+		const VectorRegister4Float DistanceSquared = VectorMax(VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ))), MinDistanceSquared);
+		const VectorRegister4Float InvDistance = VectorReciprocalSqrt(DistanceSquared);
+		const VectorRegister4Float Distance = VectorMultiply(DistanceSquared, InvDistance);
+		const VectorRegister4Float Facing = VectorMultiply(VectorMultiplyAdd(DX, ForwardX, VectorMultiplyAdd(DY, ForwardY, VectorMultiply(DZ, ForwardZ))), InvDistance);
+
+		const VectorRegister4Float Closeness = VectorSubtract(VectorOne(), VectorMultiply(Distance, InvRadiusV));
+		VectorStore(VectorMultiplyAdd(FacingW, Facing, VectorMultiply(DistanceW, Closeness)), &Scores[Index]);
+	}
+
+	for (; Index < NumCandidates; ++Index)
+	{
+		const FVector3f Delta(CandidateX[Index] - float(Origin.X), CandidateY[Index] - float(Origin.Y), CandidateZ[Index] - float(Origin.Z));
+		const float Distance = FMath::Sqrt(FMath::Max(Delta.SizeSquared(), UE_KINDA_SMALL_NUMBER));
+		const float Facing = FVector3f::DotProduct(Delta, FVector3f(Forward)) / Distance;
+
+		Scores[Index] = DistanceWeight * (1.0f - Distance * InvRadius) + FacingWeight * Facing;
+	}
+
+	// Pick the winner. Items that were claimed or went back into the pool since the last candidate update don't count.
+	float BestScore = -TNumericLimits<float>::Max();
+	for (Index = 0; Index < NumCandidates; ++Index)
+	{
+		if (Scores[Index] <= BestScore) continue;
+
+		AInteractableItem* Item = Candidates[Index].ResolveObjectPtr();
+		if (IsValid(Item) && !Item->IsPooled() && !Item->IsClaimed())
+		{
+			FocusedItem = Item;
+			BestScore = Scores[Index];
+		}
+	}
+}
+
+void UInteractionFocusComponent::AddCandidate(AInteractableItem* Item, const FVector& Location)
+{
+	const int32 Index = Candidates.Add(Item);
+	CandidateX.Add(float(Location.X));
+	CandidateY.Add(float(Location.Y));
+	CandidateZ.Add(float(Location.Z));
+	CandidateIndices.Add(Item, Index);
+}
+
+void UInteractionFocusComponent::RemoveCandidateAt(int32 Index)
+{
+	CandidateIndices.Remove(Candidates[Index]);
+
+	// Swap with the last one, so removing doesn't shift the whole arrays.
+	Candidates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CandidateX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CandidateY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CandidateZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Candidates.IsValidIndex(Index))
+	{
+		CandidateIndices[Candidates[Index]] = Index;
+	}
+}
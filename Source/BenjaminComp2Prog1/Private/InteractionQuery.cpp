@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionQuery.h"
+#include "InteractableItem.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarFroggyInteractionQueryMode(
+	TEXT("Froggy.Interaction.QueryMode"),
+	0,
+	TEXT("How Froggy finds items for pickups and interaction.\n")
+	TEXT(" 0: spatial hash (default)\n")
+	TEXT(" 1: synchronous physics overlaps/sweeps on the Interactable channel\n")
+	TEXT(" 2: async physics overlaps/sweeps, results used the next frame"));
+
+namespace InteractionQuery
+{
+	static FCollisionQueryParams MakeQueryParams(const AActor* IgnoredActor)
+	{
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(FroggyInteractionQuery), false, IgnoredActor);
+		Params.bReturnPhysicalMaterial = false;
+		return Params;
+	}
+
+	// Only accept items whose center is in range (see the comment in the header), each once.
+	static void AddItemIfInRange(const UPrimitiveComponent* Component, const FVector& Start, const FVector& End, float RadiusSquared, TArray<AInteractableItem*>& OutItems)
+	{
+		AInteractableItem* Item = Component ? Cast<AInteractableItem>(Component->GetOwner()) : nullptr;
+		if (!IsValid(Item) || Item->IsPooled() || Item->IsClaimed()) return;
+
+		if (FMath::PointDistToSegmentSquared(Item->GetActorLocation(), Start, End) <= RadiusSquared)
+		{
+			OutItems.AddUnique(Item);
+		}
+	}
+
+	EInteractionQueryMode GetMode()
+	{
+		return EInteractionQueryMode(FMath::Clamp(CVarFroggyInteractionQueryMode.GetValueOnGameThread(), 0, 2));
+	}
+
+	void OverlapItems(const UWorld* World, const FVector& Center, float Radius, const AActor* IgnoredActor, TArray<AInteractableItem*>& OutItems)
+	{
+		TArray<FOverlapResult> Overlaps;
+		World->OverlapMultiByChannel(Overlaps, Center, FQuat::Identity, ECC_Interactable, FCollisionShape::MakeSphere(Radius), MakeQueryParams(IgnoredActor));
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			AddItemIfInRange(Overlap.GetComponent(), Center, Center, Radius * Radius, OutItems);
+		}
+	}
+
+	void SweepItems(const UWorld* World, const FVector& Start, const FVector& End, float Radius, const AActor* IgnoredActor, TArray<AInteractableItem*>& OutItems)
+	{
+		if (Start.Equals(End))
+		{
+			OverlapItems(World, End, Radius, IgnoredActor, OutItems);
+			return;
+		}
+
+		// Nothing blocks on this channel, so a multi sweep returns every InteractionSphere along the way as a touch.
+		TArray<FHitResult> Hits;
+		World->SweepMultiByChannel(Hits, Start, End, FQuat::Identity, ECC_Interactable, FCollisionShape::MakeSphere(Radius), MakeQueryParams(IgnoredActor));
+
+		for (const FHitResult& Hit : Hits)
+		{
+			AddItemIfInRange(Hit.GetComponent(), Start, End, Radius * Radius, OutItems);
+		}
+	}
+
+	FTraceHandle AsyncOverlapItems(UWorld* World, const FVector& Center, float Radius, const AActor* IgnoredActor, const FOverlapDelegate& Delegate)
+	{
+		return World->AsyncOverlapByChannel(Center, FQuat::Identity, ECC_Interactable, FCollisionShape::MakeSphere(Radius),
+			MakeQueryParams(IgnoredActor), FCollisionResponseParams::DefaultResponseParam, &Delegate);
+	}
+
+	FTraceHandle AsyncSweepItems(UWorld* World, const FVector& Start, const FVector& End, float Radius, const AActor* IgnoredActor, const FTraceDelegate& Delegate)
+	{
+		return World->AsyncSweepByChannel(EAsyncTraceType::Multi, Start, End, FQuat::Identity, ECC_Interactable, FCollisionShape::MakeSphere(Radius),
+			MakeQueryParams(IgnoredActor), FCollisionResponseParams::DefaultResponseParam, &Delegate);
+	}
+
+	void GetOverlapResultItems(const FOverlapDatum& Datum, float Radius, TArray<AInteractableItem*>& OutItems)
+	{
+		for (const FOverlapResult& Overlap : Datum.OutOverlaps)
+		{
+			AddItemIfInRange(Overlap.GetComponent(), Datum.Pos, Datum.Pos, Radius * Radius, OutItems);
+		}
+	}
+
+	void GetSweepResultItems(const FTraceDatum& Datum, float Radius, TArray<AInteractableItem*>& OutItems)
+	{
+		for (const FHitResult& Hit : Datum.OutHits)
+		{
+			AddItemIfInRange(Hit.GetComponent(), Datum.Start, Datum.End, Radius * Radius, OutItems);
+		}
+	}
+}
@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemArchetypeSubsystem.h"
+#include "InteractableItem.h"
+#include "InteractableItemArchetype.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+
+// An unregistered archetype takes two rounds (the archetype itself, then its mesh/sound). More than that = broken.
+static constexpr int32 MaxLoadAttempts = 3;
+
+bool UItemArchetypeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemArchetypeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Only preload the archetypes this level actually uses, all in one batch.
+	TSet<FPrimaryAssetId> UsedArchetypes;
+	for (TActorIterator<AInteractableItem> It(&InWorld); It; ++It)
+	{
+		const FPrimaryAssetId ArchetypeId = GetArchetypeId(It->Archetype);
+		if (ArchetypeId.IsValid())
+		{
+			UsedArchetypes.Add(ArchetypeId);
+		}
+	}
+
+	if (UsedArchetypes.Num() > 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Preloading %d item archetypes for %s"), UsedArchetypes.Num(), *InWorld.GetMapName());
+		PreloadArchetypes(UsedArchetypes.Array());
+	}
+}
+
+void UItemArchetypeSubsystem::Deinitialize()
+{
+	if (LoadedArchetypes.Num() > 0 && UAssetManager::IsInitialized())
+	{
+		UAssetManager::Get().UnloadPrimaryAssets(LoadedArchetypes.Array());
+	}
+	LoadedArchetypes.Empty();
+	ArchetypeLoads.Empty();
+
+	for (TSharedPtr<FStreamableHandle>& Handle : StreamableHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	StreamableHandles.Empty();
+
+	PendingItems.Empty();
+	LoadAttempts.Empty();
+
+	Super::Deinitialize();
+}
+
+void UItemArchetypeSubsystem::PreloadArchetypes(const TArray<FPrimaryAssetId>& ArchetypeIds)
+{
+	TArray<FPrimaryAssetId> IdsToLoad;
+	for (const FPrimaryAssetId& ArchetypeId : ArchetypeIds)
+	{
+		if (ArchetypeId.IsValid() && !LoadedArchetypes.Contains(ArchetypeId))
+		{
+			IdsToLoad.Add(ArchetypeId);
+			LoadedArchetypes.Add(ArchetypeId);
+		}
+	}
+
+	if (IdsToLoad.Num() == 0) return;
+
+	// The Asset Manager keeps these loaded until UnloadPrimaryAssets - the handle is only kept (weakly) to tell a
+	// load that's still going from one that finished without the asset.
+	const TSharedPtr<FStreamableHandle> Handle = UAssetManager::Get().LoadPrimaryAssets(
+		IdsToLoad,
+		{ UInteractableItemArchetype::GameBundle },
+		FStreamableDelegate::CreateUObject(this, &UItemArchetypeSubsystem::ScheduleRetry));
+
+	for (const FPrimaryAssetId& ArchetypeId : IdsToLoad)
+	{
+		ArchetypeLoads.Add(ArchetypeId, Handle);
+	}
+}
+
+void UItemArchetypeSubsystem::UnloadArchetypes(const TArray<FPrimaryAssetId>& ArchetypeIds)
+{
+	TArray<FPrimaryAssetId> IdsToUnload;
+	for (const FPrimaryAssetId& ArchetypeId : ArchetypeIds)
+	{
+		if (LoadedArchetypes.Remove(ArchetypeId) > 0)
+		{
+			IdsToUnload.Add(ArchetypeId);
+			ArchetypeLoads.Remove(ArchetypeId);
+		}
+	}
+
+	if (IdsToUnload.Num() > 0)
+	{
+		UAssetManager::Get().UnloadPrimaryAssets(IdsToUnload);
+	}
+}
+
+void UItemArchetypeSubsystem::RequestItemAssets(AInteractableItem* Item)
+{
+	if (!IsValid(Item)) return;
+
+	if (Item->AreItemAssetsLoaded())
+	{
+		LoadAttempts.Remove(Item);
+		Item->ApplyLoadedAssets();
+		return;
+	}
+
+	int32& Attempts = LoadAttempts.FindOrAdd(Item);
+	if (++Attempts > MaxLoadAttempts)
+	{
+		UE_LOG(LogTemp, Error, TEXT("❌ Failed to load the archetype/mesh/sound of %s!"), *Item->GetName());
+		LoadAttempts.Remove(Item);
+		Item->ApplyLoadedAssets(); // Use whatever did make it
+		return;
+	}
+
+	PendingItems.AddUnique(Item);
+
+	const FPrimaryAssetId ArchetypeId = GetArchetypeId(Item->Archetype);
+	if (ArchetypeId.IsValid())
+	{
+		// Registered archetype: either already on its way, or start it now. OnAssetsLoaded picks the item up.
+		if (!LoadedArchetypes.Contains(ArchetypeId))
+		{
+			PreloadArchetypes({ ArchetypeId });
+		}
+		else if (!IsArchetypeLoading(ArchetypeId))
+		{
+			// Its load already finished without it - no callback is coming, so have OnAssetsLoaded sort it out.
+			ScheduleRetry();
+		}
+		return;
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	Item->GatherAssetsToLoad(Paths);
+	LoadSoftAssets(MoveTemp(Paths));
+}
+
+void UItemArchetypeSubsystem::PreloadItemAssets(TSubclassOf<AInteractableItem> ItemClass, const TSoftObjectPtr<UInteractableItemArchetype>& Archetype)
+{
+	const FPrimaryAssetId ArchetypeId = GetArchetypeId(Archetype);
+	if (ArchetypeId.IsValid())
+	{
+		PreloadArchetypes({ ArchetypeId });
+		return;
+	}
+
+	// No registered archetype - the class's fallback assets are what the item will need.
+	TArray<FSoftObjectPath> Paths;
+	if (!Archetype.IsNull())
+	{
+		Paths.Add(Archetype.ToSoftObjectPath());
+	}
+	else if (ItemClass)
+	{
+		ItemClass->GetDefaultObject<AInteractableItem>()->GatherAssetsToLoad(Paths);
+	}
+
+	LoadSoftAssets(MoveTemp(Paths));
+}
+
+FPrimaryAssetId UItemArchetypeSubsystem::GetArchetypeId(const TSoftObjectPtr<UInteractableItemArchetype>& Archetype)
+{
+	if (Archetype.IsNull() || !UAssetManager::IsInitialized()) return FPrimaryAssetId();
+
+	return UAssetManager::Get().GetPrimaryAssetIdForPath(Archetype.ToSoftObjectPath());
+}
+
+void UItemArchetypeSubsystem::LoadSoftAssets(TArray<FSoftObjectPath>&& Paths)
+{
+	// Skip anything that's already in memory, so we don't pile up handles for nothing.
+	Paths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull() || Path.ResolveObject() != nullptr; });
+
+	if (Paths.Num() == 0)
+	{
+		ScheduleRetry();
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(Paths),
+		FStreamableDelegate::CreateUObject(this, &UItemArchetypeSubsystem::ScheduleRetry));
+
+	if (Handle.IsValid())
+	{
+		StreamableHandles.Add(Handle);
+	}
+}
+
+void UItemArchetypeSubsystem::ScheduleRetry()
+{
+	if (bRetryScheduled) return;
+	bRetryScheduled = true;
+
+	GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UItemArchetypeSubsystem::OnAssetsLoaded));
+}
+
+bool UItemArchetypeSubsystem::IsArchetypeLoading(const FPrimaryAssetId& ArchetypeId) const
+{
+	const TWeakPtr<FStreamableHandle>* WeakHandle = ArchetypeLoads.Find(ArchetypeId);
+	const TSharedPtr<FStreamableHandle> Handle = WeakHandle ? WeakHandle->Pin() : nullptr;
+	return Handle.IsValid() && Handle->IsLoadingInProgress();
+}
+
+void UItemArchetypeSubsystem::OnAssetsLoaded()
+{
+	bRetryScheduled = false;
+
+	// Retry every waiting item. The ones that are ready get applied, the rest go back to the list.
+	TArray<TWeakObjectPtr<AInteractableItem>> WaitingItems = MoveTemp(PendingItems);
+	PendingItems.Reset();
+
+	for (const TWeakObjectPtr<AInteractableItem>& WeakItem : WaitingItems)
+	{
+		AInteractableItem* Item = WeakItem.Get();
+		if (!Item) continue;
+
+		const FPrimaryAssetId ArchetypeId = GetArchetypeId(Item->Archetype);
+		if (!Item->AreItemAssetsLoaded() && LoadedArchetypes.Contains(ArchetypeId))
+		{
+			// Still waiting on another (registered) batch - that doesn't count as a failed attempt.
+			if (IsArchetypeLoading(ArchetypeId))
+			{
+				PendingItems.Add(Item);
+				continue;
+			}
+
+			// The batch is done and the archetype still isn't there: a bad path or a failed load. Asking again would
+			// just wait forever, so give up on it.
+			UE_LOG(LogTemp, Error, TEXT("❌ Archetype %s of %s finished loading without its assets!"), *ArchetypeId.ToString(), *Item->GetName());
+			LoadAttempts.Remove(Item);
+			Item->ApplyLoadedAssets(); // Use whatever did make it
+			continue;
+		}
+
+		RequestItemAssets(Item);
+	}
+}
@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemBehaviorSubsystem.h"
+#include "InteractableItem.h"
+#include "ItemLightBudgetSubsystem.h"
+#include "FroggyStats.h"
+#include "Async/ParallelFor.h"
+#include "Components/PointLightComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarFroggyItemBehaviors(
+	TEXT("Froggy.Items.Behaviors"),
+	true,
+	TEXT("Animate items with a Behavior (bobbing, spinning, pulsing lights). 0 = every item sits still."));
+
+// Below this many, the ParallelFor isn't worth waking up the workers for.
+static constexpr int32 MinParallelBatch = 64;
+
+bool UItemBehaviorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemBehaviorSubsystem::Deinitialize()
+{
+	Items.Empty();
+	Settings.Empty();
+	Locations.Empty();
+	Phases.Empty();
+	RestLocations.Empty();
+	RestRotations.Empty();
+	RestIntensities.Empty();
+	RestCollision.Empty();
+	Results.Empty();
+	ItemIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UItemBehaviorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemBehaviorSubsystem, STATGROUP_Tickables);
+}
+
+void UItemBehaviorSubsystem::RegisterItem(AInteractableItem* Item)
+{
+	if (!Item || !Item->ObjectMesh || !Item->PointLight) return;
+
+	// Nothing to animate (anymore) - don't take up a slot.
+	if (!Item->Behavior.IsAnimated())
+	{
+		UnregisterItem(Item);
+		return;
+	}
+
+	int32 Index;
+	if (const int32* Found = ItemIndices.Find(Item))
+	{
+		Index = *Found;
+	}
+	else
+	{
+		Index = Items.Add(Item);
+		Settings.AddDefaulted();
+		Locations.AddDefaulted();
+		Phases.AddDefaulted();
+		RestLocations.Add(Item->ObjectMesh->GetRelativeLocation());
+		RestRotations.Add(Item->ObjectMesh->GetRelativeRotation());
+		RestIntensities.AddDefaulted();
+		RestCollision.Add(Item->ObjectMesh->GetCollisionEnabled());
+		Results.AddDefaulted();
+		ItemIndices.Add(Item, Index);
+	}
+
+	// A mesh that bobs or spins would teleport its physics body every frame. Interaction goes through the
+	// InteractionSphere, so the animated mesh doesn't need any collision while it moves.
+	const bool bMovesMesh = Item->Behavior.BobHeight > 0.0f || Item->Behavior.SpinSpeed != 0.0f;
+	Item->ObjectMesh->SetCollisionEnabled(bMovesMesh ? ECollisionEnabled::NoCollision : RestCollision[Index].GetValue());
+
+	const FVector Location = Item->GetActorLocation();
+	Settings[Index] = Item->Behavior;
+	Locations[Index] = FVector3f(Location);
+	RestIntensities[Index] = Item->PointLight->Intensity; // Only used without a light budget, see ApplyArchetype
+
+	// From the location rather than random, so the same level animates the same way every run (benchmarks, replays).
+	Phases[Index] = FMath::Frac(Location.X * 0.0123 + Location.Y * 0.0071) * 8.0f;
+}
+
+void UItemBehaviorSubsystem::UnregisterItem(AInteractableItem* Item)
+{
+	if (const int32* Index = ItemIndices.Find(Item))
+	{
+		RemoveAt(*Index);
+	}
+}
+
+void UItemBehaviorSubsystem::RemoveAt(int32 Index)
+{
+	// Back to the rest pose: a pooled item comes back somewhere else with a fresh start.
+	AInteractableItem* Item = Items[Index];
+	if (IsValid(Item->ObjectMesh))
+	{
+		Item->ObjectMesh->SetRelativeLocationAndRotation(RestLocations[Index], RestRotations[Index], false, nullptr, ETeleportType::TeleportPhysics);
+		Item->ObjectMesh->SetCollisionEnabled(RestCollision[Index]);
+	}
+	if (Settings[Index].PulseAmount > 0.0f)
+	{
+		if (UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>())
+		{
+			LightBudget->SetIntensityScale(Item, 1.0f);
+		}
+		else if (IsValid(Item->PointLight))
+		{
+			Item->PointLight->SetIntensity(RestIntensities[Index]);
+		}
+	}
+
+	ItemIndices.Remove(Item);
+
+	// Swap-remove everything the same way, and fix up the index of the item that got moved into the hole.
+	Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Settings.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Phases.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RestLocations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RestRotations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RestIntensities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RestCollision.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Results.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Items.IsValidIndex(Index))
+	{
+		ItemIndices.Add(Items[Index], Index);
+	}
+}
+
+void UItemBehaviorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Switched off: everyone back to the rest pose, once. Re-registering them keeps their slots for later.
+	const bool bEnabled = CVarFroggyItemBehaviors.GetValueOnGameThread();
+	if (!bEnabled)
+	{
+		if (bWasEnabled)
+		{
+			TArray<AInteractableItem*> Animated = Items;
+			while (Items.Num() > 0)
+			{
+				RemoveAt(Items.Num() - 1);
+			}
+			for (AInteractableItem* Item : Animated)
+			{
+				RegisterItem(Item);
+			}
+		}
+		bWasEnabled = false;
+		return;
+	}
+	bWasEnabled = true;
+
+	// Nothing to look at on a dedicated server.
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (Items.Num() == 0 || !PlayerController) return;
+
+	FROGGY_SCOPE_CYCLE_COUNTER(STAT_Froggy_ItemBehaviors);
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FVector3f View = FVector3f(ViewLocation);
+	const float MaxDistanceSquared = FMath::Square(MaxBehaviorDistance);
+	const double Time = GetWorld()->GetTimeSeconds();
+
+	// 1. Everyone's animation at this time, straight from the arrays.
+	ParallelFor(Items.Num(), [this, View, MaxDistanceSquared, Time](int32 Index)
+	{
+		FBehaviorResult& Result = Results[Index];
+		Result.bVisible = FVector3f::DistSquared(Locations[Index], View) <= MaxDistanceSquared;
+		if (!Result.bVisible) return;
+
+		const FItemBehaviorSettings& Behavior = Settings[Index];
+		const double ItemTime = Time + Phases[Index];
+
+		Result.Offset.Z = Behavior.BobHeight * float(FMath::Sin(UE_DOUBLE_TWO_PI * Behavior.BobFrequency * ItemTime));
+		Result.Yaw = float(FMath::Fmod(Behavior.SpinSpeed * ItemTime, 360.0));
+
+		// 1 at rest, down to 1 - PulseAmount and back
+		const float Pulse = 0.5f - 0.5f * float(FMath::Cos(UE_DOUBLE_TWO_PI * Behavior.PulseFrequency * ItemTime));
+		Result.LightScale = 1.0f - Behavior.PulseAmount * Pulse;
+	}, Items.Num() < MinParallelBatch ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// 2. Push the results to the components, only for the items somebody can actually see.
+	UItemLightBudgetSubsystem* LightBudget = GetWorld()->GetSubsystem<UItemLightBudgetSubsystem>();
+	int32 NumApplied = 0;
+	for (int32 Index = 0; Index < Items.Num(); ++Index)
+	{
+		const FBehaviorResult& Result = Results[Index];
+		AInteractableItem* Item = Items[Index];
+		if (!Result.bVisible || Item->IsHidden()) continue;
+
+		const FItemBehaviorSettings& Behavior = Settings[Index];
+		bool bApplied = false;
+
+		if ((Behavior.BobHeight > 0.0f || Behavior.SpinSpeed != 0.0f) && Item->ObjectMesh->WasRecentlyRendered(0.2f))
+		{
+			FRotator Rotation = RestRotations[Index];
+			Rotation.Yaw += Result.Yaw;
+			Item->ObjectMesh->SetRelativeLocationAndRotation(RestLocations[Index] + FVector(Result.Offset), Rotation,
+				false, nullptr, ETeleportType::TeleportPhysics);
+			bApplied = true;
+		}
+
+		// The light can be seen (on the floor around it) even when the mesh isn't, so no render check here.
+		if (Behavior.PulseAmount > 0.0f && Item->IsLightOn())
+		{
+			if (LightBudget)
+			{
+				LightBudget->SetIntensityScale(Item, Result.LightScale);
+			}
+			else
+			{
+				Item->PointLight->SetIntensity(RestIntensities[Index] * Result.LightScale);
+			}
+			bApplied = true;
+		}
+
+		NumApplied += bApplied ? 1 : 0;
+	}
+
+	FROGGY_INC_COUNTER(STAT_Froggy_AnimatedItems, NumApplied);
+}
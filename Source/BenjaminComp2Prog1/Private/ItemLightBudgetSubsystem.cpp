@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemLightBudgetSubsystem.h"
+#include "InteractableItem.h"
+#include "FroggyStats.h"
+#include "Components/PointLightComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorld GFroggyLightStatsCommand(
+	TEXT("Froggy.Lights.Stats"),
+	TEXT("Prints how many item lights are active and culled by the light budget."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UItemLightBudgetSubsystem* LightBudget = World ? World->GetSubsystem<UItemLightBudgetSubsystem>() : nullptr)
+		{
+			const FItemLightBudgetStats Stats = LightBudget->GetStats();
+			UE_LOG(LogTemp, Display, TEXT("🐸 Item lights: %d registered, %d active (%d fading), %d culled"),
+				Stats.NumRegistered, Stats.NumActive, Stats.NumFading, Stats.NumCulled);
+		}
+	}));
+
+bool UItemLightBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemLightBudgetSubsystem::Deinitialize()
+{
+	Lights.Empty();
+	LightIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UItemLightBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemLightBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UItemLightBudgetSubsystem::RegisterItem(AInteractableItem* Item)
+{
+	if (!Item || !Item->PointLight || LightIndices.Contains(Item)) return;
+
+	FManagedLight& Managed = Lights.AddDefaulted_GetRef();
+	Managed.Item = Item;
+	Managed.Light = Item->PointLight;
+	Managed.BaseIntensity = Item->PointLight->Intensity;
+
+	// Hidden until the first Tick decides it's worth showing.
+	Managed.Light->SetVisibility(false);
+
+	LightIndices.Add(Item, Lights.Num() - 1);
+}
+
+void UItemLightBudgetSubsystem::UnregisterItem(AInteractableItem* Item)
+{
+	int32 Index;
+	if (!LightIndices.RemoveAndCopyValue(Item, Index)) return;
+
+	// Leave the light the way we found it: full intensity, and hidden (the owner decides what happens next).
+	FManagedLight& Managed = Lights[Index];
+	if (IsValid(Managed.Light))
+	{
+		Managed.Light->SetIntensity(Managed.BaseIntensity);
+		Managed.Light->SetVisibility(false);
+	}
+
+	// Swap-remove, and fix up the index of the light that got moved into the hole.
+	Lights.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Lights.IsValidIndex(Index))
+	{
+		LightIndices.Add(Lights[Index].Item, Index);
+	}
+}
+
+void UItemLightBudgetSubsystem::SetBaseIntensity(AInteractableItem* Item, float NewIntensity)
+{
+	if (const int32* Index = LightIndices.Find(Item))
+	{
+		Lights[*Index].BaseIntensity = NewIntensity;
+		Lights[*Index].AppliedAlpha = -1.0f; // Force a re-apply
+	}
+}
+
+void UItemLightBudgetSubsystem::SetIntensityScale(AInteractableItem* Item, float Scale)
+{
+	if (const int32* Index = LightIndices.Find(Item))
+	{
+		Lights[*Index].IntensityScale = Scale;
+	}
+}
+
+void UItemLightBudgetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FVector ViewLocation;
+	FVector ViewDirection;
+	if (!GetViewPoint(ViewLocation, ViewDirection)) return;
+
+	// 1. Rank every light that wants to be on.
+	RankedLights.Reset();
+	for (int32 Index = 0; Index < Lights.Num(); ++Index)
+	{
+		FManagedLight& Managed = Lights[Index];
+		const bool bWantsLight = Managed.Item->IsLightOn();
+
+		float Score = bWantsLight ? ScoreLight(Managed, ViewLocation, ViewDirection) : 0.0f;
+		if (Score > 0.0f)
+		{
+			if (Managed.bInBudget)
+			{
+				Score *= KeepActiveBias;
+			}
+			RankedLights.Emplace(Score, Index);
+		}
+		Managed.bInBudget = false;
+	}
+
+	// Only bother sorting if there's more wanted lights than budget.
+	if (RankedLights.Num() > MaxActiveLights)
+	{
+		RankedLights.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+	}
+
+	const int32 NumInBudget = FMath::Min(RankedLights.Num(), MaxActiveLights);
+	for (int32 Rank = 0; Rank < NumInBudget; ++Rank)
+	{
+		Lights[RankedLights[Rank].Value].bInBudget = true;
+	}
+
+	// 2. Fade towards the target, and push the changes to the components in one pass.
+	const float FadeStep = FadeTime > 0.0f ? DeltaTime / FadeTime : 1.0f;
+
+	Stats = FItemLightBudgetStats();
+	Stats.NumRegistered = Lights.Num();
+	Stats.NumCulled = RankedLights.Num() - NumInBudget;
+
+	for (FManagedLight& Managed : Lights)
+	{
+		const float TargetAlpha = Managed.bInBudget ? 1.0f : 0.0f;
+		Managed.Alpha = FMath::Clamp(Managed.Alpha + FMath::Sign(TargetAlpha - Managed.Alpha) * FadeStep, 0.0f, 1.0f);
+
+		if (Managed.Alpha > 0.0f)
+		{
+			++Stats.NumActive;
+			if (Managed.Alpha < 1.0f)
+			{
+				++Stats.NumFading;
+			}
+		}
+
+		if (Managed.Alpha == Managed.AppliedAlpha && (Managed.Alpha == 0.0f || Managed.IntensityScale == Managed.AppliedScale)) continue;
+
+		// Only touch visibility when it flips, since that adds/removes the light from the scene.
+		const bool bWasVisible = Managed.AppliedAlpha > 0.0f;
+		const bool bIsVisible = Managed.Alpha > 0.0f;
+
+		Managed.Light->SetIntensity(Managed.BaseIntensity * Managed.Alpha * Managed.IntensityScale);
+		if (bWasVisible != bIsVisible || Managed.AppliedAlpha < 0.0f)
+		{
+			Managed.Light->SetVisibility(bIsVisible);
+		}
+
+		Managed.AppliedAlpha = Managed.Alpha;
+		Managed.AppliedScale = Managed.IntensityScale;
+	}
+
+	FROGGY_INC_COUNTER(STAT_Froggy_LightsActive, Stats.NumActive);
+	FROGGY_INC_COUNTER(STAT_Froggy_LightsFading, Stats.NumFading);
+	FROGGY_INC_COUNTER(STAT_Froggy_LightsCulled, Stats.NumCulled);
+}
+
+float UItemLightBudgetSubsystem::ScoreLight(const FManagedLight& Managed, const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	const FVector ToLight = Managed.Light->GetComponentLocation() - ViewLocation;
+	const float Distance = ToLight.Size();
+	if (Distance > MaxLightDistance) return 0.0f;
+
+	const float Radius = FMath::Max(Managed.Light->AttenuationRadius, 1.0f);
+
+	// If the camera is inside the light's radius, it's lighting what we look at no matter where it is.
+	// Otherwise lights in front of the camera matter more than lights behind it (but those still light the floor
+	// we're looking at, so they don't drop all the way to zero).
+	float ScreenWeight = 1.0f;
+	if (Distance > Radius)
+	{
+		const float Facing = FVector::DotProduct(ToLight / Distance, ViewDirection);
+		ScreenWeight = FMath::Lerp(0.2f, 1.0f, (Facing + 1.0f) * 0.5f);
+	}
+
+	// Roughly how big the light's area of influence looks from here.
+	return ScreenWeight * Radius / (Distance + Radius);
+}
+
+bool UItemLightBudgetSubsystem::GetViewPoint(FVector& OutLocation, FVector& OutDirection) const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController) return false;
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+	OutDirection = ViewRotation.Vector();
+	return true;
+}
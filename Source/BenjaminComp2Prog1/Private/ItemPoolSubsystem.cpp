@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPoolSubsystem.h"
+#include "InteractableItem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// Prints the pool counters of the current world. Handy to check that a cleared room really did no spawning.
+static FAutoConsoleCommandWithWorld GFroggyPoolStatsCommand(
+	TEXT("Froggy.Pool.Stats"),
+	TEXT("Prints the item pool hit/miss counters for the current world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UItemPoolSubsystem* Pool = World ? World->GetSubsystem<UItemPoolSubsystem>() : nullptr)
+		{
+			const FItemPoolStats Stats = Pool->GetStats();
+			UE_LOG(LogTemp, Display, TEXT("🐸 Item pool: %d hits, %d misses, %d releases, %d sleeping"),
+				Stats.Hits, Stats.Misses, Stats.Releases, Stats.NumPooled);
+		}
+	}));
+
+bool UItemPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemPoolSubsystem::Deinitialize()
+{
+	// The pooled actors belong to the level and get cleaned up with it, we just forget about them.
+	FreeLists.Empty();
+
+	Super::Deinitialize();
+}
+
+AInteractableItem* UItemPoolSubsystem::AcquireItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform)
+{
+	if (!ItemClass) return nullptr;
+
+	if (FItemPoolFreeList* FreeList = FreeLists.Find(ItemClass))
+	{
+		// Skip anything that was destroyed behind our back (e.g. by a level unload) while sleeping.
+		while (FreeList->Items.Num() > 0)
+		{
+			AInteractableItem* Item = FreeList->Items.Pop(EAllowShrinking::No);
+			if (IsValid(Item))
+			{
+				++Hits;
+				Item->ActivateFromPool(Transform);
+				return Item;
+			}
+		}
+	}
+
+	++Misses;
+	return SpawnItem(ItemClass, Transform);
+}
+
+void UItemPoolSubsystem::ReleaseItem(AInteractableItem* Item)
+{
+	if (!IsValid(Item) || Item->IsPooled()) return;
+
+	Item->DeactivateForPool();
+	++Releases;
+
+	// Items placed in a streaming level / World Partition cell go away when it unloads, so they can sleep but must
+	// not be handed out as someone else's item. Only persistent level actors are recycled.
+	if (Item->GetLevel() != GetWorld()->PersistentLevel) return;
+
+	FreeLists.FindOrAdd(Item->GetClass()).Items.Add(Item);
+}
+
+void UItemPoolSubsystem::Prewarm(TSubclassOf<AInteractableItem> ItemClass, int32 Count)
+{
+	if (!ItemClass) return;
+
+	FItemPoolFreeList& FreeList = FreeLists.FindOrAdd(ItemClass);
+	FreeList.Items.Reserve(FreeList.Items.Num() + Count);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (AInteractableItem* Item = SpawnItem(ItemClass, FTransform::Identity))
+		{
+			Item->DeactivateForPool();
+			FreeList.Items.Add(Item);
+		}
+	}
+}
+
+FItemPoolStats UItemPoolSubsystem::GetStats() const
+{
+	FItemPoolStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Releases = Releases;
+
+	for (const TPair<TSubclassOf<AInteractableItem>, FItemPoolFreeList>& Pair : FreeLists)
+	{
+		Stats.NumPooled += Pair.Value.Items.Num();
+	}
+
+	return Stats;
+}
+
+void UItemPoolSubsystem::ResetStats()
+{
+	Hits = 0;
+	Misses = 0;
+	Releases = 0;
+}
+
+AInteractableItem* UItemPoolSubsystem::SpawnItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	return GetWorld()->SpawnActor<AInteractableItem>(ItemClass, Transform, SpawnParams);
+}
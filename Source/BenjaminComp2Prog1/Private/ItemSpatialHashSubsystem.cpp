@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemSpatialHashSubsystem.h"
+#include "InteractableItem.h"
+
+void UItemSpatialHashSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Config values are loaded after the constructor, so the grid gets (re)built here with the real CellSize.
+	Grid = TSpatialHashGrid<AInteractableItem*>(CellSize);
+}
+
+void UItemSpatialHashSubsystem::Deinitialize()
+{
+	Grid.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UItemSpatialHashSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemSpatialHashSubsystem::RegisterItem(AInteractableItem* Item)
+{
+	if (!Item) return;
+
+	Grid.Add(Item, Item->GetActorLocation());
+	++Revision;
+}
+
+void UItemSpatialHashSubsystem::UnregisterItem(AInteractableItem* Item)
+{
+	Grid.Remove(Item);
+}
+
+void UItemSpatialHashSubsystem::UpdateItem(AInteractableItem* Item)
+{
+	// Add() moves items that are already in the grid, but we don't want UpdateItem to sneak new items in.
+	if (Item && Grid.Contains(Item))
+	{
+		Grid.Add(Item, Item->GetActorLocation());
+		++Revision;
+	}
+}
+
+void UItemSpatialHashSubsystem::QueryItemsInRadius(const FVector& Center, float Radius, TArray<AInteractableItem*>& OutItems) const
+{
+	Grid.ForEachInRadius(Center, Radius, [&OutItems](AInteractableItem* Item, const FVector&, float)
+	{
+		if (IsValid(Item))
+		{
+			OutItems.Add(Item);
+		}
+	});
+}
+
+void UItemSpatialHashSubsystem::QueryItemsAlongPath(const FVector& Start, const FVector& End, float Radius, TArray<AInteractableItem*>& OutItems) const
+{
+	Grid.ForEachAlongSegment(Start, End, Radius, [&OutItems](AInteractableItem* Item, const FVector&, float)
+	{
+		if (IsValid(Item))
+		{
+			OutItems.Add(Item);
+		}
+	});
+}
+
+void UItemSpatialHashSubsystem::QueryNearestItems(const FVector& Center, float Radius, int32 MaxCount, TArray<AInteractableItem*>& OutItems) const
+{
+	// Items that are pending kill (Destroy() called this frame) may still be in the grid until EndPlay. They're
+	// skipped before MaxCount is applied, so they can't push valid items out of the result.
+	Grid.QueryNearest(Center, Radius, MaxCount, OutItems, [](AInteractableItem* Item) { return IsValid(Item); });
+}
+
+AInteractableItem* UItemSpatialHashSubsystem::FindNearestItem(const FVector& Center, float Radius) const
+{
+	AInteractableItem* NearestItem = nullptr;
+	float NearestDistanceSquared = TNumericLimits<float>::Max();
+
+	Grid.ForEachInRadius(Center, Radius, [&NearestItem, &NearestDistanceSquared](AInteractableItem* Item, const FVector&, float DistanceSquared)
+	{
+		if (DistanceSquared < NearestDistanceSquared && IsValid(Item))
+		{
+			NearestItem = Item;
+			NearestDistanceSquared = DistanceSquared;
+		}
+	});
+
+	return NearestItem;
+}
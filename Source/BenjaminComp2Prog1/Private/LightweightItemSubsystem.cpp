@@ -0,0 +1,480 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LightweightItemSubsystem.h"
+#include "InteractableItem.h"
+#include "ItemPoolSubsystem.h"
+#include "ItemArchetypeSubsystem.h"
+#include "InteractableItemArchetype.h"
+#include "FroggyCharacter.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+
+void ULightweightItemSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	// The pool has to exist before us, since promoting and demoting go through it.
+	Collection.InitializeDependency<UItemPoolSubsystem>();
+	Collection.InitializeDependency<UItemArchetypeSubsystem>();
+
+	Super::Initialize(Collection);
+
+	DormantGrid = TSpatialHashGrid<int32>(CellSize);
+}
+
+void ULightweightItemSubsystem::Deinitialize()
+{
+	Items.Empty();
+	FreeHandles.Empty();
+	PromotedHandles.Empty();
+	PendingMeshHandles.Empty();
+	DormantGrid.Empty();
+	MeshGroups.Empty();
+	InstanceRenderer = nullptr;
+	NumInUse = 0;
+
+	Super::Deinitialize();
+}
+
+bool ULightweightItemSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId ULightweightItemSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULightweightItemSubsystem, STATGROUP_Tickables);
+}
+
+void ULightweightItemSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// In multiplayer, items are replicated actors that the server owns - turning them into local instance data
+	// would fight replication. They go network dormant instead, which is what makes idle items cheap there.
+	if (InWorld.GetNetMode() != NM_Standalone) return;
+
+	// One plain actor to own all the HISM components
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = TEXT("LightweightItemRenderer");
+	SpawnParams.ObjectFlags |= RF_Transient;
+	InstanceRenderer = InWorld.SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+	USceneComponent* RendererRoot = NewObject<USceneComponent>(InstanceRenderer, TEXT("Root"));
+	InstanceRenderer->SetRootComponent(RendererRoot);
+	RendererRoot->RegisterComponent();
+
+	// Placed items that opted in are turned into data right away. The first Tick promotes the ones near the player.
+	TArray<AInteractableItem*> ItemsToConvert;
+	for (TActorIterator<AInteractableItem> It(&InWorld); It; ++It)
+	{
+		// Only the persistent level: a streamed cell unloads its own actors, but a record made from one would stay
+		// around forever - memory should follow the streaming distance, not the level size.
+		if (It->bUseLightweightInstancing && It->GetLevel() == InWorld.PersistentLevel)
+		{
+			ItemsToConvert.Add(*It);
+		}
+	}
+
+	for (AInteractableItem* Item : ItemsToConvert)
+	{
+		AddFromActor(Item);
+	}
+
+	if (ItemsToConvert.Num() > 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Converted %d placed items to lightweight instances"), ItemsToConvert.Num());
+	}
+}
+
+int32 ULightweightItemSubsystem::AddLightweightItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform)
+{
+	if (!ItemClass) return INDEX_NONE;
+
+	// No actor to read from, so the class defaults decide what the item looks like and does.
+	const AInteractableItem* Defaults = ItemClass->GetDefaultObject<AInteractableItem>();
+
+	const int32 Handle = AllocateRecord();
+	FLightweightItem& Record = Items[Handle];
+	Record.ItemClass = ItemClass;
+	Record.Transform = Transform;
+	Record.Archetype = Defaults->Archetype;
+	Record.InteractionSound = Defaults->InteractionSound;
+	Record.bDestroyOnInteract = Defaults->bDestroyOnInteract;
+	Record.bToggleLight = Defaults->bToggleLight;
+	Record.bIsAPickup = Defaults->bIsAPickup;
+	Record.bLightOn = Defaults->IsLightOn();
+
+	if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->PreloadItemAssets(ItemClass, Record.Archetype);
+	}
+
+	ShowInstance(Handle);
+	DormantGrid.Add(Handle, Transform.GetLocation());
+
+	return Handle;
+}
+
+int32 ULightweightItemSubsystem::AddFromActor(AInteractableItem* Item)
+{
+	if (!IsValid(Item) || Item->IsPooled()) return INDEX_NONE;
+
+	const int32 Handle = AllocateRecord();
+	FLightweightItem& Record = Items[Handle];
+	Record.ItemClass = Item->GetClass();
+	Record.Transform = Item->GetActorTransform();
+	Record.Archetype = Item->Archetype;
+	Record.InteractionSound = Item->InteractionSound;
+	Record.bDestroyOnInteract = Item->bDestroyOnInteract;
+	Record.bToggleLight = Item->bToggleLight;
+	Record.bIsAPickup = Item->bIsAPickup;
+	Record.bLightOn = Item->IsLightOn();
+	Record.SaveId = Item->GetSaveId();
+
+	// The placed actor may already carry its mesh (saved with the level) - then there's nothing to wait for.
+	if (Item->ObjectMesh->GetStaticMesh())
+	{
+		Record.Mesh = Item->ObjectMesh->GetStaticMesh();
+		Record.MeshTransform = Item->ObjectMesh->GetRelativeTransform();
+	}
+	else if (UItemArchetypeSubsystem* Archetypes = GetWorld()->GetSubsystem<UItemArchetypeSubsystem>())
+	{
+		Archetypes->PreloadItemAssets(Record.ItemClass, Record.Archetype);
+	}
+
+	ShowInstance(Handle);
+	DormantGrid.Add(Handle, Record.Transform.GetLocation());
+
+	// The whole point is to not have the actor around anymore.
+	Item->Destroy();
+
+	return Handle;
+}
+
+void ULightweightItemSubsystem::RemoveLightweightItem(int32 Handle)
+{
+	if (!Items.IsValidIndex(Handle) || !Items[Handle].bInUse) return;
+
+	FLightweightItem& Record = Items[Handle];
+	if (Record.Actor)
+	{
+		AInteractableItem* Actor = Record.Actor;
+		Record.Actor = nullptr;
+		Actor->SetLightweightHandle(INDEX_NONE);
+		PromotedHandles.RemoveSwap(Handle);
+
+		if (UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+		{
+			Pool->ReleaseItem(Actor);
+		}
+	}
+
+	HideInstance(Record);
+	DormantGrid.Remove(Handle);
+	FreeRecord(Handle);
+}
+
+void ULightweightItemSubsystem::NotifyItemRemoved(AInteractableItem* Item)
+{
+	const int32 Handle = Item ? Item->GetLightweightHandle() : INDEX_NONE;
+	if (!Items.IsValidIndex(Handle) || Items[Handle].Actor != Item) return;
+
+	// Picked up or consumed while promoted - the item is gone for good, so it shouldn't come back as an instance.
+	Item->SetLightweightHandle(INDEX_NONE);
+	Items[Handle].Actor = nullptr;
+	PromotedHandles.RemoveSwap(Handle);
+	FreeRecord(Handle);
+}
+
+void ULightweightItemSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Every frame, so items added this frame show up right away - however many there were, it's one call per mesh.
+	FlushPendingInstances();
+
+	// No need to do this every frame, the player doesn't walk 600 units in 0.1 seconds.
+	TimeUntilNextCheck -= DeltaTime;
+	if (TimeUntilNextCheck > 0.0f) return;
+	TimeUntilNextCheck = CheckInterval;
+
+	// Items whose mesh wasn't loaded yet when they became dormant get another go.
+	if (PendingMeshHandles.Num() > 0)
+	{
+		TArray<int32> HandlesToRetry = MoveTemp(PendingMeshHandles);
+		PendingMeshHandles.Reset();
+		for (const int32 Handle : HandlesToRetry)
+		{
+			if (Items[Handle].bInUse && !Items[Handle].Actor)
+			{
+				ShowInstance(Handle);
+			}
+		}
+	}
+
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	GatherPlayerLocations(PlayerLocations);
+
+	// Promote: the dormant grid only holds non-promoted items, so this only finds new ones.
+	TArray<int32> HandlesToPromote;
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		DormantGrid.QueryRadius(PlayerLocation, PromoteRadius, HandlesToPromote);
+	}
+
+	for (const int32 Handle : HandlesToPromote)
+	{
+		// Two players close to the same item would find it twice - the second time it's no longer in the grid.
+		if (DormantGrid.Contains(Handle))
+		{
+			Promote(Handle);
+		}
+	}
+
+	// Demote: the promoted list is only ever as long as what's around the players, so this stays cheap.
+	const float DemoteRadiusSquared = DemoteRadius * DemoteRadius;
+	for (int32 Index = PromotedHandles.Num() - 1; Index >= 0; --Index)
+	{
+		const FVector ItemLocation = Items[PromotedHandles[Index]].Transform.GetLocation();
+
+		const bool bNearAnyPlayer = PlayerLocations.ContainsByPredicate([&](const FVector& PlayerLocation)
+		{
+			return FVector::DistSquared(PlayerLocation, ItemLocation) <= DemoteRadiusSquared;
+		});
+
+		if (!bNearAnyPlayer)
+		{
+			Demote(PromotedHandles[Index]);
+			PromotedHandles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	// Instance transforms were updated without touching the render state, so push each changed HISM once.
+	for (TPair<TObjectPtr<UStaticMesh>, FLightweightItemMeshGroup>& Pair : MeshGroups)
+	{
+		if (Pair.Value.bRenderStateDirty)
+		{
+			Pair.Value.Instances->MarkRenderStateDirty();
+			Pair.Value.bRenderStateDirty = false;
+		}
+	}
+}
+
+void ULightweightItemSubsystem::Promote(int32 Handle)
+{
+	UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+	if (!Pool) return;
+
+	FLightweightItem& Record = Items[Handle];
+
+	AInteractableItem* Actor = Pool->AcquireItem(Record.ItemClass, Record.Transform);
+	if (!Actor) return;
+
+	// Give the actor back the state the item was left in. The archetype goes last, since its sound wins.
+	Actor->InteractionSound = Record.InteractionSound;
+	Actor->bDestroyOnInteract = Record.bDestroyOnInteract;
+	Actor->bToggleLight = Record.bToggleLight;
+	Actor->bIsAPickup = Record.bIsAPickup;
+	Actor->SetLightOn(Record.bLightOn);
+	Actor->SetArchetype(Record.Archetype);
+	Actor->SetLightweightHandle(Handle);
+	Actor->SetSaveId(Record.SaveId); // A pooled actor, but it stands in for the placed item now
+
+	Record.Actor = Actor;
+	HideInstance(Record);
+	DormantGrid.Remove(Handle);
+	PromotedHandles.Add(Handle);
+}
+
+void ULightweightItemSubsystem::Demote(int32 Handle)
+{
+	FLightweightItem& Record = Items[Handle];
+	AInteractableItem* Actor = Record.Actor;
+	Record.Actor = nullptr;
+
+	if (IsValid(Actor))
+	{
+		// Remember what the player did to the item, before the pool resets it.
+		if (Record.Archetype != Actor->Archetype)
+		{
+			Record.Mesh = nullptr; // Resolved again from the new archetype
+			Record.Archetype = Actor->Archetype;
+		}
+		Record.InteractionSound = Actor->InteractionSound;
+		Record.bDestroyOnInteract = Actor->bDestroyOnInteract;
+		Record.bToggleLight = Actor->bToggleLight;
+		Record.bIsAPickup = Actor->bIsAPickup;
+		Record.bLightOn = Actor->IsLightOn();
+		Record.SaveId = Actor->GetSaveId();
+
+		Actor->SetLightweightHandle(INDEX_NONE);
+		if (UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+		{
+			Pool->ReleaseItem(Actor);
+		}
+	}
+
+	ShowInstance(Handle);
+	DormantGrid.Add(Handle, Record.Transform.GetLocation());
+}
+
+int32 ULightweightItemSubsystem::AllocateRecord()
+{
+	int32 Handle;
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+		Items[Handle] = FLightweightItem();
+	}
+	else
+	{
+		Handle = Items.AddDefaulted();
+	}
+
+	Items[Handle].bInUse = true;
+	++NumInUse;
+	return Handle;
+}
+
+void ULightweightItemSubsystem::FreeRecord(int32 Handle)
+{
+	Items[Handle] = FLightweightItem();
+	FreeHandles.Add(Handle);
+	--NumInUse;
+}
+
+bool ULightweightItemSubsystem::ResolveMesh(FLightweightItem& Record) const
+{
+	if (Record.Mesh) return true;
+
+	// Archetype first, then whatever the class itself uses - the same order the actor applies them in.
+	if (!Record.Archetype.IsNull())
+	{
+		const UInteractableItemArchetype* LoadedArchetype = Record.Archetype.Get();
+		if (!LoadedArchetype || !LoadedArchetype->Mesh.IsValid()) return false;
+
+		Record.Mesh = LoadedArchetype->Mesh.Get();
+		Record.MeshTransform = FTransform(FQuat::Identity, FVector::ZeroVector, LoadedArchetype->MeshScale);
+		return true;
+	}
+
+	const AInteractableItem* Defaults = Record.ItemClass->GetDefaultObject<AInteractableItem>();
+	Record.Mesh = Defaults->ObjectMesh->GetStaticMesh() ? Defaults->ObjectMesh->GetStaticMesh() : Defaults->FallbackMesh.Get();
+	Record.MeshTransform = Defaults->ObjectMesh->GetRelativeTransform();
+	return Record.Mesh != nullptr;
+}
+
+void ULightweightItemSubsystem::ShowInstance(int32 Handle)
+{
+	FLightweightItem& Record = Items[Handle];
+	if (Record.InstanceIndex != INDEX_NONE) return;
+
+	if (!ResolveMesh(Record))
+	{
+		// Still loading - Tick tries again.
+		PendingMeshHandles.AddUnique(Handle);
+		return;
+	}
+
+	FLightweightItemMeshGroup* Group = FindOrCreateMeshGroup(Record.Mesh);
+	if (!Group) return;
+
+	const FTransform InstanceTransform = Record.MeshTransform * Record.Transform;
+
+	if (Group->FreeInstances.Num() > 0)
+	{
+		Record.InstanceIndex = Group->FreeInstances.Pop(EAllowShrinking::No);
+		Group->Instances->UpdateInstanceTransform(Record.InstanceIndex, InstanceTransform, true, false, true);
+	}
+	else
+	{
+		// Spawning 100k items would otherwise be 100k AddInstance calls - they're all added together next tick.
+		Record.InstanceIndex = FLightweightItem::PendingInstanceIndex;
+		Group->PendingTransforms.Add(InstanceTransform);
+		Group->PendingHandles.Add(Handle);
+	}
+
+	Group->bRenderStateDirty = true;
+}
+
+void ULightweightItemSubsystem::HideInstance(FLightweightItem& Record)
+{
+	if (Record.InstanceIndex == INDEX_NONE) return;
+
+	FLightweightItemMeshGroup* Group = MeshGroups.Find(Record.Mesh);
+	if (!Group) return;
+
+	// Not in the HISM yet - add the batch now, so the item has a real slot to hide (and hand to the free list).
+	if (Record.InstanceIndex == FLightweightItem::PendingInstanceIndex)
+	{
+		FlushPendingInstances(*Group);
+	}
+
+	// Scaled to nothing instead of removed, and the slot goes on the free list for the next item.
+	const FTransform HiddenTransform(FQuat::Identity, Record.Transform.GetLocation(), FVector::ZeroVector);
+	Group->Instances->UpdateInstanceTransform(Record.InstanceIndex, HiddenTransform, true, false, true);
+	Group->FreeInstances.Add(Record.InstanceIndex);
+	Group->bRenderStateDirty = true;
+
+	Record.InstanceIndex = INDEX_NONE;
+}
+
+void ULightweightItemSubsystem::FlushPendingInstances(FLightweightItemMeshGroup& Group)
+{
+	if (Group.PendingHandles.Num() == 0) return;
+
+	const TArray<int32> NewIndices = Group.Instances->AddInstances(Group.PendingTransforms, true, true);
+	for (int32 Index = 0; Index < Group.PendingHandles.Num(); ++Index)
+	{
+		Items[Group.PendingHandles[Index]].InstanceIndex = NewIndices[Index];
+	}
+
+	Group.PendingTransforms.Reset();
+	Group.PendingHandles.Reset();
+}
+
+void ULightweightItemSubsystem::FlushPendingInstances()
+{
+	for (TPair<TObjectPtr<UStaticMesh>, FLightweightItemMeshGroup>& Pair : MeshGroups)
+	{
+		FlushPendingInstances(Pair.Value);
+	}
+}
+
+FLightweightItemMeshGroup* ULightweightItemSubsystem::FindOrCreateMeshGroup(UStaticMesh* Mesh)
+{
+	if (!Mesh || !InstanceRenderer) return nullptr;
+
+	if (FLightweightItemMeshGroup* Existing = MeshGroups.Find(Mesh))
+	{
+		return Existing;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(InstanceRenderer);
+	Instances->SetStaticMesh(Mesh);
+	// Nothing collides with lightweight items, the grid is how the game finds them.
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetGenerateOverlapEvents(false);
+	Instances->SetupAttachment(InstanceRenderer->GetRootComponent());
+	Instances->RegisterComponent();
+
+	FLightweightItemMeshGroup& Group = MeshGroups.Add(Mesh);
+	Group.Instances = Instances;
+	return &Group;
+}
+
+void ULightweightItemSubsystem::GatherPlayerLocations(TArray<FVector, TInlineAllocator<4>>& OutLocations) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (const AFroggyCharacter* Froggy = PlayerController ? Cast<AFroggyCharacter>(PlayerController->GetPawn()) : nullptr)
+		{
+			OutLocations.Add(Froggy->GetActorLocation());
+		}
+	}
+}
@@ -3,8 +3,32 @@
 
 #include "MyGameMode.h"
 #include "FroggyCharacter.h"
+#include "FroggyInventoryComponent.h"
 #include "ProtagonistController.h"
+#include "ItemSpatialHashSubsystem.h"
+#include "FroggySaveSubsystem.h"
+#include "Engine/GameInstance.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+static TAutoConsoleVariable<float> CVarFroggyNetStatsInterval(
+	TEXT("Froggy.Net.StatsInterval"),
+	5.0f,
+	TEXT("How often (seconds) a server logs player count, frame time and bandwidth. 0 = off."));
+
+static FAutoConsoleCommandWithWorld GFroggyNetStatsCommand(
+	TEXT("Froggy.Net.Stats"),
+	TEXT("Prints player count, server frame time and net bandwidth (server only)."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const AMyGameMode* GameMode = World ? World->GetAuthGameMode<AMyGameMode>() : nullptr)
+		{
+			GameMode->LogNetStats();
+		}
+	}));
 
 AMyGameMode::AMyGameMode()
 {
@@ -34,5 +58,43 @@ void AMyGameMode::StartPlay()
 	check(GEngine != nullptr);
 
 	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Purple, TEXT("Hello World, this is myGameMode!"));
+
+	const float StatsInterval = CVarFroggyNetStatsInterval.GetValueOnGameThread();
+	if (GetNetMode() != NM_Standalone && StatsInterval > 0.0f)
+	{
+		GetWorldTimerManager().SetTimer(NetStatsTimerHandle, this, &AMyGameMode::LogNetStats, StatsInterval, true);
+	}
+}
+
+APawn* AMyGameMode::SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot)
+{
+	// Only the local player - the save only has the one Froggy.
+	UFroggySaveSubsystem* Saves = UGameInstance::GetSubsystem<UFroggySaveSubsystem>(GetGameInstance());
+	FFroggySavedPlayer SavedPlayer;
+	if (Saves && NewPlayer && NewPlayer->IsLocalController() && Saves->ConsumeSavedPlayer(GetWorld(), SavedPlayer))
+	{
+		APawn* Pawn = SpawnDefaultPawnAtTransform(NewPlayer, FTransform(SavedPlayer.Rotation, SavedPlayer.Location));
+		if (AFroggyCharacter* Froggy = Cast<AFroggyCharacter>(Pawn))
+		{
+			Froggy->SetSitting(SavedPlayer.bIsSitting);
+			Froggy->GetInventory()->ApplySnapshot(SavedPlayer.InventoryIds, SavedPlayer.InventoryCounts);
+		}
+		return Pawn;
+	}
+
+	return Super::SpawnDefaultPawnFor_Implementation(NewPlayer, StartSpot);
+}
+
+void AMyGameMode::LogNetStats() const
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver) return;
+
+	const UItemSpatialHashSubsystem* ItemIndex = GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>();
+
+	// GGameThreadTime is the game thread work of the last frame, without the idle wait for the server tick rate.
+	UE_LOG(LogTemp, Display, TEXT("🐸 Server: %d players, %d items, game thread %.2f ms, out %.1f KB/s, in %.1f KB/s"),
+		GetNumPlayers(), ItemIndex ? ItemIndex->GetNumItems() : 0, FPlatformTime::ToMilliseconds(GGameThreadTime),
+		NetDriver->OutBytesPerSecond / 1024.0f, NetDriver->InBytesPerSecond / 1024.0f);
 }
 
@@ -11,23 +11,39 @@
 // ...I learned of the SetupPlayerInputComponent after doing the below code, and I'm too lazy.
 // I'll fix it when I reuse this for my group project - move it over and optimize the code.
 // Which is exactly why it's nice to have this Comp_1 assignment, to do bad first-time code, and improve next time. :3
+//
+// Update: the input assets are loaded async now, so BeginPlay only binds if they happen to be ready already.
+// Otherwise the Froggy calls SetupFroggyInput itself when its input bundle finishes loading.
 void AProtagonistController::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Get the Local Player Subsystem - which manages input mappings per local player (used to add or remove input mappings dynamically)
-	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer());
-	if (!InputSubsystem)
+	// Get the controlled FroggyCharacter
+	AFroggyCharacter* FroggyCharacter = Cast<AFroggyCharacter>(GetPawn());
+	if (!FroggyCharacter)
 	{
-		UE_LOG(LogTemp, Error, TEXT("❌ Failed to get UEnhancedInputLocalPlayerSubsystem! Input mapping will not be applied."));
+		UE_LOG(LogTemp, Display, TEXT("🐸 No Froggy possessed yet - input gets bound once its assets are loaded."));
 		return;
 	}
 
-	// Get the controlled FroggyCharacter
-	AFroggyCharacter* FroggyCharacter = Cast<AFroggyCharacter>(GetPawn());
-	if (!FroggyCharacter)
+	if (!FroggyCharacter->AreInputAssetsLoaded())
+	{
+		UE_LOG(LogTemp, Display, TEXT("🐸 Froggy input assets still loading - input gets bound when they're done."));
+		return;
+	}
+
+	SetupFroggyInput(FroggyCharacter);
+}
+
+void AProtagonistController::SetupFroggyInput(AFroggyCharacter* FroggyCharacter)
+{
+	if (!FroggyCharacter) return;
+
+	// Get the Local Player Subsystem - which manages input mappings per local player (used to add or remove input mappings dynamically)
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer());
+	if (!InputSubsystem)
 	{
-		UE_LOG(LogTemp, Error, TEXT("❌ Froggy Character not found inside ProtagonistController.cpp!"));
+		UE_LOG(LogTemp, Error, TEXT("❌ Failed to get UEnhancedInputLocalPlayerSubsystem! Input mapping will not be applied."));
 		return;
 	}
 
@@ -46,6 +62,13 @@ void AProtagonistController::BeginPlay()
 		UE_LOG(LogTemp, Error, TEXT("❌ EnhancedInputComponent not found! Input binding will fail."));
 		return;
 	}
+
+	// Both BeginPlay and the load callback can end up here - only bind a given input component once.
+	if (BoundInputComponent.Get() == EnhancedInputComponent)
+	{
+		return;
+	}
+	BoundInputComponent = EnhancedInputComponent;
 	
 	BindInputs(FroggyCharacter, EnhancedInputComponent);
 
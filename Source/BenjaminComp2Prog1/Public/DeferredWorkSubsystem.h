@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Deque.h"
+#include "DeferredWorkSubsystem.generated.h"
+
+/** How the deferred work queue is keeping up. */
+USTRUCT(BlueprintType)
+struct FDeferredWorkStats
+{
+	GENERATED_BODY()
+
+	// Jobs waiting right now
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 QueueDepth = 0;
+
+	// The most jobs that were ever waiting at once
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 PeakQueueDepth = 0;
+
+	// Jobs run so far
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 NumExecuted = 0;
+
+	// Jobs skipped because the object they belonged to was gone by the time it was their turn
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 NumSkipped = 0;
+
+	// Frames where the queue ran past FrameBudgetMs (a single slow job can do that - we don't cut jobs in half)
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 NumOverruns = 0;
+
+	// Frames that ended with work still left in the queue
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	int32 NumBacklogFrames = 0;
+
+	// Time spent running jobs last frame, in ms
+	UPROPERTY(BlueprintReadOnly, Category = "Deferred Work")
+	float LastFrameMs = 0.0f;
+};
+
+/**
+ * A game thread queue for work that doesn't have to happen right now - effects, sounds, on-screen messages,
+ * sending items back to the pool.
+ *
+ * Gameplay code does the important part immediately (e.g. "this item is claimed, nobody else can pick it up"), and
+ * queues the rest with Enqueue(). Every frame the queue runs jobs in order until FrameBudgetMs is used up; whatever
+ * is left waits for the next frame. So grabbing 30 items at once costs a bit over a few frames instead of one big
+ * hitch. Every frame runs at least one job, so the queue always makes progress.
+ *
+ * Jobs belong to an object - if that object is gone (or pending kill) by the time it's its turn, the job is skipped.
+ * Use "Froggy.Work.Stats" in the console to see queue depth and overruns.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UDeferredWorkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Queues Work to run on the game thread in a later Tick, as long as Owner is still around then. */
+	void Enqueue(const UObject* Owner, TUniqueFunction<void()>&& Work);
+
+	/** Runs everything that's queued right now, ignoring the budget. E.g. before a save or a level change. */
+	void Flush();
+
+	UFUNCTION(BlueprintCallable, Category = "Deferred Work")
+	FDeferredWorkStats GetStats() const { return Stats; }
+
+	/**
+	 * Queues Work in World's deferred work subsystem, or just runs it right away if there is none
+	 * (e.g. in editor worlds) - so callers never have to handle both cases.
+	 */
+	static void EnqueueOrRun(UWorld* World, const UObject* Owner, TUniqueFunction<void()>&& Work);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FDeferredJob
+	{
+		TWeakObjectPtr<const UObject> Owner;
+		TUniqueFunction<void()> Work;
+	};
+
+	/** Pops and runs the oldest job. */
+	void RunNextJob();
+
+	// How much game thread time the queue may use per frame, in ms
+	UPROPERTY(Config)
+	float FrameBudgetMs = 1.0f;
+
+	TDeque<FDeferredJob> Queue;
+	FDeferredWorkStats Stats;
+};
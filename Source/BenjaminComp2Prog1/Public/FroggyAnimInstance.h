@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "FroggyAnimInstance.generated.h"
+
+class AFroggyCharacter;
+class UAnimSequenceBase;
+struct FStreamableHandle;
+
+/** What Froggy's body is doing. Exactly one at a time, the previous one blends out over BlendTime. */
+UENUM(BlueprintType)
+enum class EFroggyAnimState : uint8
+{
+	Idle,
+	Walk,
+	Sit,
+	OpenDoor	// The long interact
+};
+
+/** The handful of things the animation needs from Froggy. Copied on the game thread, read by the worker. */
+struct FFroggyAnimInputs
+{
+	FVector Velocity = FVector::ZeroVector;
+	bool bIsSitting = false;
+	bool bIsFalling = false;
+	uint32 LongInteractCount = 0;	// Goes up by one for every long interact - a change starts the door animation
+};
+
+/**
+ * Worker thread side of UFroggyAnimInstance. Samples the current (and while blending, the previous) sequence and
+ * crossfades them - the whole anim graph, without an anim graph.
+ */
+USTRUCT()
+struct FFroggyAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FFroggyAnimInstanceProxy() = default;
+	FFroggyAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	// Written by UFroggyAnimInstance::NativeThreadSafeUpdateAnimation, read in Evaluate. Both on the same worker.
+	const UAnimSequenceBase* CurrentSequence = nullptr;
+	const UAnimSequenceBase* PreviousSequence = nullptr;
+	float CurrentTime = 0.0f;
+	float PreviousTime = 0.0f;
+	float BlendAlpha = 1.0f;	// 0 = all previous, 1 = all current
+
+protected:
+	virtual bool Evaluate(FPoseContext& Output) override;
+};
+
+/**
+ * Native animation for the Froggy rig: Idle / Walk / Sit / OpenDoor, all in C++.
+ *
+ * - NativeUpdateAnimation (game thread) only copies FFroggyAnimInputs off the character - a few bytes, no logic.
+ *   This is what an anim blueprint's property access does in its pre-update copy, minus the blueprint.
+ * - NativeThreadSafeUpdateAnimation (worker thread) runs the state machine, advances the play times and fills the
+ *   proxy, which samples and blends the sequences in Evaluate. No Blueprint VM anywhere.
+ *
+ * "stat Froggy" shows the game thread and worker time of this; "stat anim" the engine side. To compare against
+ * everything on the game thread, run with a.ParallelAnimUpdate 0.
+ *
+ * A Blueprint subclass can swap the sequences; the state (Speed, State, ...) is readable for anything built on top.
+ */
+UCLASS(Transient, Blueprintable)
+class BENJAMINCOMP2PROG1_API UFroggyAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UFroggyAnimInstance();
+
+	// Soft references, loaded async when the anim instance starts - until then Froggy stands in the ref pose.
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	TSoftObjectPtr<UAnimSequenceBase> IdleAnimation;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	TSoftObjectPtr<UAnimSequenceBase> WalkAnimation;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	TSoftObjectPtr<UAnimSequenceBase> SitAnimation;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	TSoftObjectPtr<UAnimSequenceBase> OpenDoorAnimation;
+
+	// Faster than this (cm/s) counts as walking
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	float WalkStartSpeed = 10.0f;
+
+	// Slower than this goes back to idle. A bit below WalkStartSpeed, so Froggy doesn't flicker between the two.
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	float WalkStopSpeed = 5.0f;
+
+	// The speed the walk animation was made for - the walk plays faster/slower to match the real speed
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	float WalkAnimationSpeed = 300.0f;
+
+	// Crossfade time between states, in seconds
+	UPROPERTY(EditDefaultsOnly, Category = "Froggy|Animation")
+	float BlendTime = 0.2f;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Froggy|Animation")
+	EFroggyAnimState State = EFroggyAnimState::Idle;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Froggy|Animation")
+	float Speed = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Froggy|Animation")
+	bool bIsSitting = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Froggy|Animation")
+	bool bIsOpeningDoor = false;
+
+	/** Plays this state no matter what, at normal speed. For meshes without a Froggy - the crowd's pose leaders. */
+	void SetForcedState(EFroggyAnimState InState) { ForcedState = InState; bHasForcedState = true; }
+
+protected:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeUninitializeAnimation() override;
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
+private:
+	void OnAnimationsLoaded();
+
+	/** The state Froggy should be in, given the inputs. Worker thread. */
+	EFroggyAnimState ChooseState() const;
+
+	const UAnimSequenceBase* GetSequence(EFroggyAnimState ForState) const;
+	static bool IsLooping(EFroggyAnimState ForState) { return ForState == EFroggyAnimState::Idle || ForState == EFroggyAnimState::Walk; }
+
+	/** Moves a play time along, wrapping for looping states and holding the last frame for the others. */
+	static float AdvanceTime(const UAnimSequenceBase* Sequence, float Time, float DeltaSeconds, bool bLooping);
+
+	UPROPERTY(Transient)
+	TObjectPtr<AFroggyCharacter> Froggy;
+
+	// Resolved from the soft references once they're loaded. The worker only ever reads these.
+	UPROPERTY(Transient)
+	TObjectPtr<UAnimSequenceBase> LoadedSequences[4];
+
+	TSharedPtr<FStreamableHandle> AnimationsHandle;
+
+	FFroggyAnimInputs Inputs;	// Game thread writes (NativeUpdateAnimation), worker reads after
+
+	// Worker thread state
+	EFroggyAnimState PreviousState = EFroggyAnimState::Idle;
+	float StateTime = 0.0f;
+	float PreviousStateTime = 0.0f;
+	float BlendElapsed = 0.0f;
+	uint32 LastLongInteractCount = 0;
+
+	// Set once on the game thread, before the first update (see SetForcedState)
+	EFroggyAnimState ForcedState = EFroggyAnimState::Idle;
+	bool bHasForcedState = false;
+};
@@ -8,6 +8,7 @@
 #include "Logging/LogMacros.h"
 #include "InputActionValue.h"
 #include "InteractableItem.h"
+#include "WorldCollision.h"
 #include "FroggyCharacter.generated.h"
 
 /**
@@ -23,12 +24,15 @@
 class USpringArmComponent;
 class UCameraComponent;
 class USphereComponent;
+class UInteractionFocusComponent;
+class UFroggyInventoryComponent;
 class UInputMappingContext;
 class UInputAction;
 
 class AProtagonistController;
 
 struct FInputActionValue;
+struct FStreamableHandle;
 /**
  * UCLASS(Config=Game) means that default values are being stored in DefaultGame.ini, letting us tweak settings directly
  * in the .ini files. It means we can change the values in .ini without having to recompile the game every time.
@@ -61,18 +65,31 @@ class BENJAMINCOMP2PROG1_API AFroggyCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera", meta = (AllowPrivateAccess = "true"))
 	USphereComponent* PickupSphere;
 
+	/** Keeps track of the items in InteractRadius and which one is the best to interact with */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Interaction", meta = (AllowPrivateAccess = "true"))
+	UInteractionFocusComponent* InteractionFocus;
+
+	/** Everything Froggy has picked up (filled on the server, replicated to the owner) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Interaction", meta = (AllowPrivateAccess = "true"))
+	UFroggyInventoryComponent* Inventory;
+
 	/** Custom Protagonist Controller */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Controller", meta = (AllowPrivateAccess = "true"))
 	AProtagonistController* ProtagonistController;
 	
-	/** MappingContext */
+	/** MappingContext (soft reference - loaded async together with the IA_* actions, see RequestInputAssets) */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
-	UInputMappingContext* IMC_Player;
+	TSoftObjectPtr<UInputMappingContext> IMC_Player;
 
 	// The radius in which the player can interact/pick up items
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (AllowPrivateAccess = "true"))
 	float PickupRadius = 110.0f;
 
+	// The radius in which the player can interact with items. PickupRadius + the item's InteractionSphere (80),
+	// which matches what the old "pickup sphere overlaps interaction sphere" check used to find.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (AllowPrivateAccess = "true"))
+	float InteractRadius = 190.0f;
+
 	/** Interact Hold Threshold, before long Interact happens */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character", meta = (AllowPrivateAccess = "true"))
 	float InteractHoldTimeThreshold = 1.0f; // How long it takes for LongInteract to happen
@@ -82,18 +99,105 @@ class BENJAMINCOMP2PROG1_API AFroggyCharacter : public ACharacter
 	float LookSensitivity = 1.0f; // How much to multiply the mouse-look input with
 
 	/** Is the Froggy sitting? */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character", meta = (AllowPrivateAccess = "true"))
-	bool bIsSitting = false; // Tracks if the player is sitting.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Character", meta = (AllowPrivateAccess = "true"))
+	bool bIsSitting = false; // Tracks if the player is sitting. (Replicated, push-model)
 	
 	FTimerHandle InteractHoldTimerHandle; // Timer Handle to help track hold duration with Interact
 	float InteractHoldTime = 0.0f; // Stores how long the Interact button is held;
+	uint32 LongInteractCount = 0; // +1 per long interact, the anim instance plays the door opening when it changes
 	
 	FTimerHandle PickupTimerHandle; // Timer Handle for often the player checks for nearby pick-ups.
-	float PickupCheckTimeInterval = 0.10f; // The actual time between checks in float value. 
+	float PickupCheckTimeInterval = 0.10f; // The longest time between checks (standing still / walking slowly).
+	float MinPickupCheckInterval = 0.02f; // The shortest time between checks (running fast).
+	float MaxSweepDistance = 2000.0f; // Moved further than this since the last check? Then it was a teleport, don't sweep.
+
+	FVector LastPickupCheckLocation = FVector::ZeroVector; // Where Froggy was at the last pickup check
+	uint32 LastPickupCheckRevision = 0; // The spatial hash revision at the last pickup check
+	bool bHasPickupCheckLocation = false; // False until the first check
+	FTraceHandle PickupQueryHandle; // The async pickup sweep in flight, if any
+	bool bPickupChecksEnabled = true; // Off for far away crowd Froggies (see UFroggyCrowdSubsystem)
+
+	/** Runs CheckForNearbyItems and schedules the next check, sooner the faster Froggy moves. */
+	void UpdatePickupCheck();
+
+	/** AI Froggies are part of the crowd (UFroggyCrowdSubsystem), player Froggies aren't. Re-checked when that can change. */
+	void UpdateCrowdMembership();
+
+	/** Froggy.Interaction.QueryMode 2: the pickup sweep CheckForNearbyItems started last frame has finished. */
+	void OnAsyncPickupQueryDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	/** Picks up everything a pickup check found. */
+	void PickupFoundItems(const TArray<AInteractableItem*>& Items);
+
+	// How much further than InteractRadius the server still accepts an interact from a client. The client picked
+	// the item where it saw Froggy a few ms ago, so it can be a bit off from where the server has Froggy now.
+	float ServerInteractTolerance = 100.0f;
+
+	/**
+	 * Client-side prediction. A client doesn't wait for the server to see its interaction/pickup happen: it applies it
+	 * right away (AInteractableItem::PredictInteract/PredictPickup), sends the request with a prediction key, and the
+	 * server answers with that key in Client_AckPrediction. A "no" (somebody else was faster, out of reach) rolls it back.
+	 *
+	 * Measure it on a local server with lag, e.g. "NetEmulation.PktLag 150" and "NetEmulation.PktLoss 5" in the client
+	 * console (or -PktLag=150 -PktLoss=5 on the command line), then "Froggy.Net.PredictionStats".
+	 * Froggy.Net.Predict 0 sends the same requests but waits for the server, to compare how it feels.
+	 */
+	struct FPendingPrediction
+	{
+		TWeakObjectPtr<AInteractableItem> Item;
+		double SentTime = 0.0;
+		bool bWasPickup = false;
+		bool bPredicted = false; // False if Froggy.Net.Predict was off - then we just wait for the server
+	};
+
+	struct FPredictionStats
+	{
+		int32 NumRequests = 0;
+		int32 NumPredicted = 0;
+		int32 NumConfirmed = 0;
+		int32 NumRejected = 0;
+		double TotalRoundTripMs = 0.0; // Request -> answer. With prediction on, that's the latency the player didn't see.
+		double MaxRoundTripMs = 0.0;
+	};
+
+	TMap<uint16, FPendingPrediction> PendingPredictions;
+	FPredictionStats PredictionStats;
+	uint16 NextPredictionKey = 1;
+
+	/** Client: predicts (if enabled) and sends the interact/pickup request for Item. */
+	void RequestItemAction(AInteractableItem* Item, bool bPickup);
+
+	/** Is there already a request for this item waiting on the server? Then don't send another one. */
+	bool HasPendingPrediction(const AInteractableItem* Item) const;
+
+	/** Should this copy of Froggy look for pickups? The locally controlled one does, the server does it for AI. */
+	bool ShouldCheckForPickups() const;
+
+	/** Client -> server: "I want to interact with this item". The server checks it's in reach and does it. */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_Interact(AInteractableItem* Item, uint16 PredictionKey);
+
+	/** Client -> server: "I walked into this pickup". Same deal as Server_Interact, with PickupRadius. */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_PickupItem(AInteractableItem* Item, uint16 PredictionKey);
+
+	/** Server -> client: the answer to a request. bStillAvailable tells a rollback whether to show the item again. */
+	UFUNCTION(Client, Reliable)
+	void Client_AckPrediction(uint16 PredictionKey, bool bAccepted, bool bStillAvailable);
+
+	/** Server: in reach of the item, give or take ServerInteractTolerance? */
+	bool IsInReachOnServer(const AInteractableItem* Item, float Radius) const;
+
+	/** Client -> server: "I sat down / stood up". */
+	UFUNCTION(Server, Reliable)
+	void Server_SetSitting(bool bNewIsSitting);
+
+	TSharedPtr<FStreamableHandle> InputAssetsHandle; // Keeps the input assets loaded (soft pointers don't do that on their own)
+	double InputAssetsRequestTime = 0.0; // When the input bundle was requested, to measure how long the load took
 
 public:
-	// Sets default values for this character's properties
-	AFroggyCharacter();
+	// Sets default values for this character's properties. Swaps in UFroggyMovementComponent as the movement component.
+	AFroggyCharacter(const FObjectInitializer& ObjectInitializer);
 
 	UFUNCTION(BlueprintCallable, Category = "Character")
 	void CheckForNearbyItems();
@@ -104,7 +208,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
 	void Interact();
 
-	// Blueprint event that designers or others can override to define custom behaviour
+	// Blueprint event that designers or others can override to define custom behaviour.
+	// The item Froggy is interacting with is GetInteractionFocus()->GetFocusedItem().
 	UFUNCTION(BlueprintImplementableEvent, Category = "Interaction")
 	void OnInteract(bool bWasLongInteract);
 
@@ -128,19 +233,23 @@ protected:
 	
 	/** Move Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
-	UInputAction* IA_Move;
+	TSoftObjectPtr<UInputAction> IA_Move;
 
 	/** Sit Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
-	UInputAction* IA_Sit;
+	TSoftObjectPtr<UInputAction> IA_Sit;
 
 	/** Interact Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
-	UInputAction* IA_Interact;
+	TSoftObjectPtr<UInputAction> IA_Interact;
 
 	/** Look Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
-	UInputAction* IA_Look;
+	TSoftObjectPtr<UInputAction> IA_Look;
+
+	/** Starts loading the mapping context and IA_* actions as one async bundle; binds input when it's done. */
+	void RequestInputAssets();
+	void OnInputAssetsLoaded();
 
 	/** Called when Interacting; has to do with short or long interact */
 	void UpdateHoldTime();
@@ -150,7 +259,13 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	
 	virtual void NotifyControllerChanged() override;
+
+	virtual void OnRep_PlayerState() override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	
@@ -165,24 +280,44 @@ public:
 	 * 10 Inline Functions: 10x 20 bytes = 200 bytes total (10 separate copies!).
 	*/
 
-	// Getter methods to access IA_* actions
-	UInputAction* GetIA_Move() const { return IA_Move; }
-	UInputAction* GetIA_Sit() const { return IA_Sit; }
-	UInputAction* GetIA_Interact() const { return IA_Interact; }
-	UInputAction* GetIA_Look() const { return IA_Look; }
+	// Getter methods to access IA_* actions. These return nullptr until the input bundle has finished loading.
+	UInputAction* GetIA_Move() const { return IA_Move.Get(); }
+	UInputAction* GetIA_Sit() const { return IA_Sit.Get(); }
+	UInputAction* GetIA_Interact() const { return IA_Interact.Get(); }
+	UInputAction* GetIA_Look() const { return IA_Look.Get(); }
+
+	// True once the mapping context and all IA_* actions are loaded
+	bool AreInputAssetsLoaded() const;
+
+	// Logs how many interactions/pickups this client predicted, how many the server rejected, and the round trips.
+	void LogPredictionStats() const;
 
 	UFUNCTION(BlueprintCallable, Category = "Character")
 	bool GetIsSitting() const { return bIsSitting; }
+
+	uint32 GetLongInteractCount() const { return LongInteractCount; }
+
+	/** Sets bIsSitting (and marks it for replication). Also used when a save game spawns Froggy. */
+	void SetSitting(bool bNewIsSitting);
+
+	/** Starts/stops the pickup polling. The crowd turns it off for Froggies nobody's close enough to see pick things up. */
+	void SetPickupChecksEnabled(bool bEnabled);
 	
 	UFUNCTION(BlueprintCallable, Category = Input)
 	UEnhancedInputComponent* GetEnhancedInputComponent() const { return Cast<UEnhancedInputComponent>(InputComponent); }
 	
 	// Getter function for the mapping context
 	UFUNCTION(BlueprintCallable, Category = Input)
-	FORCEINLINE class UInputMappingContext* GetMappingContext() const { return IMC_Player; }
+	FORCEINLINE class UInputMappingContext* GetMappingContext() const { return IMC_Player.Get(); }
 	
 	/** Returns CameraBoom subObject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subObject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns InteractionFocus subobject **/
+	FORCEINLINE class UInteractionFocusComponent* GetInteractionFocus() const { return InteractionFocus; }
+	/** Returns Inventory subobject **/
+	FORCEINLINE class UFroggyInventoryComponent* GetInventory() const { return Inventory; }
+	/** Returns the CharacterMovement subobject as what it really is **/
+	class UFroggyMovementComponent* GetFroggyMovement() const;
 };
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FroggyAnimInstance.h"
+#include "FroggyCrowdSubsystem.generated.h"
+
+class AFroggyCharacter;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+/** How much work a crowd Froggy gets. Higher is more. The order matters, it's compared and used as an index. */
+UENUM(BlueprintType)
+enum class EFroggyCrowdTier : uint8
+{
+	Dormant,	// Far away or out of sight: barely ticks, shared pose
+	Shared,		// Shares a pose with the rest of the crowd, slower movement
+	Reduced,	// Own animation (URO skips frames), slower movement
+	Full		// Like the player's Froggy
+};
+
+/** How many crowd Froggies are in which tier. */
+USTRUCT(BlueprintType)
+struct FFroggyCrowdStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumRegistered = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumFull = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumReduced = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumShared = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumDormant = 0;
+
+	// Tier changes in the last update - should be a handful, not the whole crowd
+	UPROPERTY(BlueprintReadOnly, Category = "Crowd")
+	int32 NumChanged = 0;
+};
+
+/**
+ * Keeps hundreds of AI Froggies cheap.
+ *
+ * Every AI-controlled Froggy registers with the engine's significance manager (the SignificanceManager plugin), which
+ * scores them all against every player's view each frame (in parallel). The score is the distance to the closest
+ * view, doubled for Froggies that weren't rendered lately. Then this walks the ranked list once and puts every Froggy
+ * in a tier (EFroggyCrowdTier) - the closest MaxFullDetail get full detail, the rest goes by distance. Only Froggies
+ * whose tier changed are touched, so a crowd that stands around costs close to nothing here.
+ *
+ * What a tier changes:
+ * - Movement: the CharacterMovementComponent ticks less often (it substeps, so they still get where they're going).
+ *   Froggies on the lightweight movement (UFroggyMovementComponent) aren't ticked on their own, so this doesn't apply.
+ * - Animation: Update Rate Optimizations are always on for Froggies (set in the constructor), so URO already skips
+ *   frames for small ones on screen. The Shared and Dormant tiers stop running their own animation at all and copy
+ *   the pose of a hidden "leader" mesh instead (SetLeaderPoseComponent) - one leader per Idle/Walk/Sit for the whole
+ *   crowd. Which leader is picked from the Froggy's speed and sitting, re-checked every LeaderRecheckInterval.
+ *   Off-screen, anything below Full only ticks its pose when rendered.
+ * - Pickups: only Full and Reduced Froggies poll for nearby items (AFroggyCharacter::SetPickupChecksEnabled).
+ *
+ * The player's own Froggy (and other players') are never part of the crowd.
+ *
+ * "Froggy.Crowd.Stats" for the tier counts, "Froggy.Crowd.Enable 0" to run everyone at full detail for comparison,
+ * "Froggy.Crowd.Spawn N" to spawn a test crowd. "stat Froggy" has the cost of the update.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UFroggyCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an AI Froggy to the crowd. It starts at full detail until the first update ranks it. */
+	void RegisterFroggy(AFroggyCharacter* Froggy);
+
+	/** Takes a Froggy out of the crowd and gives it full detail back (e.g. a player took control of it). */
+	void UnregisterFroggy(AFroggyCharacter* Froggy);
+
+	bool IsRegistered(const AFroggyCharacter* Froggy) const { return Members.Contains(Froggy); }
+
+	UFUNCTION(BlueprintCallable, Category = "Crowd")
+	FFroggyCrowdStats GetStats() const { return Stats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCrowdMember
+	{
+		EFroggyCrowdTier Tier = EFroggyCrowdTier::Full;
+	};
+
+	/** The tier a Froggy at this (effective) distance should be in, before the MaxFullDetail cap. */
+	EFroggyCrowdTier GetTierForDistance(float Distance, EFroggyCrowdTier CurrentTier) const;
+
+	void ApplyTier(AFroggyCharacter* Froggy, FCrowdMember& Member, EFroggyCrowdTier NewTier);
+
+	/** Sets (or clears, for Full/Reduced) the leader the Froggy copies its pose from. */
+	void ApplyLeader(AFroggyCharacter* Froggy, const FCrowdMember& Member);
+	static EFroggyAnimState GetLeaderState(const AFroggyCharacter* Froggy);
+
+	/** The hidden mesh playing State for everyone sharing it. Made the first time it's needed. */
+	USkeletalMeshComponent* GetLeader(EFroggyAnimState State, USkeletalMesh* Mesh);
+
+	void GatherViewpoints();
+
+	/** Significance <-> effective distance. The significance manager sorts by the first, the tiers use the second. */
+	static float DistanceToSignificance(float Distance) { return 1.0f / (1.0f + Distance); }
+	static float SignificanceToDistance(float Significance) { return Significance > 0.0f ? 1.0f / Significance - 1.0f : MAX_flt; }
+
+	/** Closer than this is Full detail (up to MaxFullDetail Froggies). */
+	UPROPERTY(Config)
+	float FullDetailDistance = 1500.0f;
+
+	/** Closer than this gets its own animation. */
+	UPROPERTY(Config)
+	float ReducedDistance = 4000.0f;
+
+	/** Closer than this is Shared, further is Dormant. */
+	UPROPERTY(Config)
+	float SharedDistance = 8000.0f;
+
+	/** At most this many crowd Froggies at full detail, however many are close. */
+	UPROPERTY(Config)
+	int32 MaxFullDetail = 16;
+
+	/** A Froggy that wasn't rendered lately counts as this much further away. */
+	UPROPERTY(Config)
+	float HiddenDistanceScale = 2.0f;
+
+	/** A Froggy only drops a tier once it's this much (fraction) past the distance, so it doesn't flip back and forth. */
+	UPROPERTY(Config)
+	float Hysteresis = 0.1f;
+
+	/** Seconds between movement ticks, per tier. Full always ticks every frame. */
+	UPROPERTY(Config)
+	float ReducedMovementTickInterval = 0.05f;
+
+	UPROPERTY(Config)
+	float SharedMovementTickInterval = 0.2f;
+
+	UPROPERTY(Config)
+	float DormantMovementTickInterval = 0.5f;
+
+	/** How often Froggies in a shared tier check whether they should follow a different leader (walk/idle/sit). */
+	UPROPERTY(Config)
+	float LeaderRecheckInterval = 0.25f;
+
+	// Raw pointers are fine: Froggies always unregister in EndPlay.
+	TMap<AFroggyCharacter*, FCrowdMember> Members;
+
+	// Holds the leader meshes. Spawned on demand, never on a dedicated server (nothing's rendered there anyway).
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> LeaderActor;
+
+	UPROPERTY(Transient)
+	TObjectPtr<USkeletalMeshComponent> Leaders[4];	// By EFroggyAnimState, OpenDoor stays empty
+
+	// Reused every frame, so the update doesn't allocate
+	TArray<FTransform> Viewpoints;
+
+	float LeaderRecheckTime = 0.0f;
+	bool bWasEnabled = true;
+
+	FFroggyCrowdStats Stats;
+};
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FroggyInputReplaySubsystem.generated.h"
+
+class AFroggyCharacter;
+class UInputAction;
+class UEnhancedInputLocalPlayerSubsystem;
+
+/** The Froggy input actions that get recorded. Index into the file's action table, so only ever add to the end. */
+enum class EFroggyRecordedAction : uint8
+{
+	Move,
+	Look,
+	Sit,
+	Interact,
+
+	Count
+};
+
+/** One frame of recorded input. */
+struct FFroggyInputFrame
+{
+	float DeltaSeconds = 0.0f;	// How long the frame was when it was recorded
+	uint8 ActiveMask = 0;		// Bit per EFroggyRecordedAction: the action had a non-zero value this frame
+	FVector3f Values[uint8(EFroggyRecordedAction::Count)];
+};
+
+/**
+ * Records the local Froggy's input and plays it back, for repeatable performance runs.
+ *
+ * Recording reads the value of IA_Move / IA_Look / IA_Sit / IA_Interact every frame (after Enhanced Input has
+ * processed it) and keeps it in memory. Stopping writes Saved/InputRecordings/<Name>.finp:
+ *   "FINP", version, the value type of every action, the frame count, then per frame: its delta time, a byte
+ *   saying which actions were active, and only the active actions' values (1-3 floats). An idle frame is 5 bytes.
+ *
+ * Replaying injects the recorded values back into Enhanced Input (InjectInputForAction), so they go through the
+ * same bindings AProtagonistController::BindInputs set up - Started/Triggered/Completed, holds and all. It runs
+ * with a fixed timestep, so two replays do exactly the same frames, and writes the wall time of every frame to
+ * Saved/Profiling/FroggyReplay/<Name>-<date>.csv, with a mean/p50/p95/p99/max summary in the log.
+ * Compare those between builds.
+ *
+ * Headless, from the command line:
+ *   UnrealEditor-Cmd BenjaminComp2Prog1.uproject -game -nullrhi -unattended -nosound
+ *     -FroggyReplay=<Name> [-FroggyReplayStep=0.016667] -FroggyReplayQuit
+ * Without -FroggyReplayStep, the step is the recording's average frame time. -FroggyRecord=<Name> starts a
+ * recording right away (record with -usefixedtimestep -fps=60 for the closest match).
+ *
+ * In the console: Froggy.Input.Record [Name], Froggy.Input.Replay [Name] [Step], Froggy.Input.Stop.
+ *
+ * Values are recorded after the mapping context's modifiers, and injection only applies the action's own
+ * modifiers - so keep modifiers on the mapping context, not on the IA_* assets, or they'd be applied twice.
+ * Both recording and replay start once the local Froggy's input is bound, and replay runs one frame behind the
+ * recording (injected input is processed the frame after). Anything not driven by input (AI, physics) isn't
+ * recorded.
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UFroggyInputReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** "FINP" and the file version. Bump the version when the layout changes. */
+	static constexpr uint32 FileMagic = 0x504E4946;
+	static constexpr uint16 FileVersion = 1;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool StartRecording(const FString& Name);
+
+	/** Starts replaying a recording. FixedStep <= 0 uses the recording's average frame time. */
+	bool StartReplay(const FString& Name, float FixedStep, bool bInQuitWhenDone);
+
+	/** Stops recording (and writes the file) or replaying (and writes the timings so far). */
+	void Stop();
+
+	bool IsRecording() const { return Mode == EMode::Recording; }
+	bool IsReplaying() const { return Mode == EMode::Replaying; }
+
+	static FString GetRecordingPath(const FString& Name);
+
+	static bool WriteRecording(const FString& Path, const uint8 (&ValueTypes)[uint8(EFroggyRecordedAction::Count)], const TArray<FFroggyInputFrame>& Frames);
+	static bool ReadRecording(const FString& Path, uint8 (&OutValueTypes)[uint8(EFroggyRecordedAction::Count)], TArray<FFroggyInputFrame>& OutFrames);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EMode : uint8
+	{
+		None,
+		Recording,
+		Replaying
+	};
+
+	/** The local Froggy, once its input is bound - nothing is recorded/replayed before that. */
+	AFroggyCharacter* GetReadyFroggy(UEnhancedInputLocalPlayerSubsystem*& OutInput) const;
+	static const UInputAction* GetAction(const AFroggyCharacter* Froggy, EFroggyRecordedAction Action);
+
+	void RecordFrame(const AFroggyCharacter* Froggy, const UEnhancedInputLocalPlayerSubsystem* Input, float DeltaTime);
+	void ReplayFrame(const AFroggyCharacter* Froggy, UEnhancedInputLocalPlayerSubsystem* Input);
+
+	void FinishRecording();
+	void FinishReplay();
+
+	EMode Mode = EMode::None;
+	FString CurrentName;
+
+	TArray<FFroggyInputFrame> Frames;
+	uint8 ValueTypes[uint8(EFroggyRecordedAction::Count)] = {};	// EInputActionValueType per action
+	int32 NextReplayFrame = 0;
+	bool bQuitWhenDone = false;
+
+	// What the fixed timestep was before the replay, to put it back
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	// Wall time of every replayed frame
+	TArray<float> FrameTimesMs;
+	double LastFrameTime = 0.0;
+};
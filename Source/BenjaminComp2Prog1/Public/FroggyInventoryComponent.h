@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "FroggyInventoryComponent.generated.h"
+
+class UFroggyInventoryComponent;
+struct FFroggyInventoryList;
+
+/** A stack of one kind of item: just the id and how many. No UObject per entry. */
+USTRUCT(BlueprintType)
+struct FFroggyInventoryStack : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	// The item's archetype asset name, or its class name without an archetype (see AInteractableItem::GetInventoryId)
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	FName ItemId;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 Count = 0;
+
+	// Client: Count as of the last update, not replicated. PostReplicatedChange only sees the new count, this is how
+	// it knows what to add to the total.
+	int32 LastCount = 0;
+
+	// Client side, called by the fast array replication
+	void PreReplicatedRemove(const FFroggyInventoryList& InArraySerializer);
+	void PostReplicatedAdd(const FFroggyInventoryList& InArraySerializer);
+	void PostReplicatedChange(const FFroggyInventoryList& InArraySerializer);
+};
+
+/** All stacks, replicated as a delta array: only stacks that were added, changed or removed are sent. */
+USTRUCT()
+struct FFroggyInventoryList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FFroggyInventoryStack> Stacks;
+
+	// Not replicated, set by the component
+	UFroggyInventoryComponent* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FFroggyInventoryStack, FFroggyInventoryList>(Stacks, DeltaParms, *this);
+	}
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFroggyInventoryList> : public TStructOpsTypeTraitsBase2<FFroggyInventoryList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnFroggyInventoryChanged, FName /*ItemId*/, int32 /*NewCount*/);
+
+/**
+ * What Froggy has picked up, as stacks of item ids with a count.
+ *
+ * The stacks are one flat array of small structs (id + count), plus an id -> index map, so GetCount is a single
+ * lookup and adding to an existing stack touches nothing else. A stack that runs out is swap-removed. Nothing ticks,
+ * and once the arrays have grown (or Reserve was called) adding and removing doesn't allocate.
+ *
+ * Only the server changes the inventory; the owning client gets it through the fast array replication (only the
+ * stacks that changed are sent) and keeps its own index. Other clients don't get it at all.
+ *
+ * Saved by UFroggySaveSubsystem with the rest of the player, as an id block and a count block.
+ * "Froggy.Bench.Inventory" measures add/remove/query throughput.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class BENJAMINCOMP2PROG1_API UFroggyInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFroggyInventoryComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Adds Count of the item (server only). Returns the new count of its stack. */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 AddItem(FName ItemId, int32 Count = 1);
+
+	/** One of each id, e.g. everything an area pickup got. Ids can repeat. Marks the list dirty once for all of them. */
+	void AddItems(TConstArrayView<FName> ItemIds);
+
+	/** Takes up to Count of the item away (server only). Returns how many were actually removed. */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 RemoveItem(FName ItemId, int32 Count = 1);
+
+	/** One of each id. Returns how many were actually removed. */
+	int32 RemoveItems(TConstArrayView<FName> ItemIds);
+
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 GetCount(FName ItemId) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 GetNumStacks() const { return Inventory.Stacks.Num(); }
+
+	/** All items, over all stacks. */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 GetTotalCount() const { return TotalCount; }
+
+	const TArray<FFroggyInventoryStack>& GetStacks() const { return Inventory.Stacks; }
+
+	/** Makes room for this many stacks up front, so filling the inventory doesn't reallocate. */
+	void Reserve(int32 NumStacks);
+
+	/** Removes everything (server only). */
+	void Empty();
+
+	/** The inventory as two parallel arrays, for the save file. */
+	void GetSnapshot(TArray<FName>& OutItemIds, TArray<int32>& OutCounts) const;
+
+	/** Replaces the inventory with a saved one (server only). */
+	void ApplySnapshot(TConstArrayView<FName> ItemIds, TConstArrayView<int32> Counts);
+
+	/** Memory held by the stacks and the index. */
+	SIZE_T GetAllocatedSize() const { return Inventory.Stacks.GetAllocatedSize() + StackIndices.GetAllocatedSize(); }
+
+	/** A stack changed (0 = it's gone). On the server and the owning client. */
+	FOnFroggyInventoryChanged OnInventoryChanged;
+
+private:
+	friend struct FFroggyInventoryStack;
+	friend struct FFroggyInventoryList;
+
+	/** Standalone components (no owner, e.g. the benchmark) count as the server. */
+	bool CanModify() const;
+
+	/** The part of AddItem/AddItems for one stack, without the broadcast and the push-model dirty. Returns the new count. */
+	int32 AddToStack(FName ItemId, int32 Count);
+
+	/** Same for removing. Returns how many were removed. */
+	int32 RemoveFromStack(FName ItemId, int32 Count);
+
+	/** Swap-removes the stack and fixes the index of the one that moved into its place. */
+	void RemoveStackAt(int32 Index);
+
+	void RebuildIndex();
+
+	/** Replicated properties are push-model - this marks the whole list for the next net update. */
+	void MarkInventoryDirty();
+
+	UPROPERTY(Replicated)
+	FFroggyInventoryList Inventory;
+
+	// ItemId -> index into Inventory.Stacks
+	TMap<FName, int32> StackIndices;
+
+	int32 TotalCount = 0;
+
+	// Client: replication added or removed stacks, so indices moved. Rebuilt once the whole update is in.
+	bool bIndexDirty = false;
+
+	// Client: the stacks an update changed, broadcast once it's all in and the index is right again - so a
+	// handler can call GetCount.
+	TArray<TPair<FName, int32>> PendingBroadcasts;
+};
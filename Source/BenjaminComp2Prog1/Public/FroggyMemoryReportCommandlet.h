@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FroggyMemoryReportCommandlet.generated.h"
+
+/**
+ * Loads a map and reports what the AInteractableItems and AFroggyCharacters in it cost in memory, per instance:
+ * - UObject: the actor, its components and every other object inside it (anim instance, ...) - class size plus what
+ *   their containers allocate, like "obj list" counts it.
+ * - Render proxy: the primitives' scene proxies (GetMemoryFootprint) and the light proxies. Commandlets don't render
+ *   by default, so pass -AllowCommandletRendering for this column, or it stays 0.
+ * - Physics: the body instances of primitives with physics state.
+ * Shared assets (meshes, materials, sounds) aren't counted - they're paid once, not per item.
+ *
+ * It prints a table per class, extrapolates the per-item cost to 10k and 100k items, writes it all as CSV to
+ * Saved/Profiling/FroggyMemory/, and returns 1 if a budget below is exceeded (2 if the map couldn't be loaded), so a
+ * headless run catches memory regressions:
+ *
+ *   UnrealEditor-Cmd BenjaminComp2Prog1.uproject -run=FroggyMemoryReport [-Map=L_MainLevel] [-AllowCommandletRendering]
+ *     [-MaxBytesPerItem=N] [-MaxBytesPerFroggy=N] [-MaxLevelBytes=N]
+ *
+ * The budgets come from [/Script/BenjaminComp2Prog1.FroggyMemoryReportCommandlet] in DefaultGame.ini; the command
+ * line overrides them. 0 means no budget.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UFroggyMemoryReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFroggyMemoryReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Map to load without -Map=. A bare name is looked for in /Game. */
+	UPROPERTY(Config)
+	FString DefaultMap = TEXT("/Game/L_MainLevel");
+
+	/** Everything one item costs (UObject + proxies + physics). */
+	UPROPERTY(Config)
+	int64 MaxBytesPerItem = 0;
+
+	UPROPERTY(Config)
+	int64 MaxBytesPerFroggy = 0;
+
+	/** All items and Froggies in the map together. */
+	UPROPERTY(Config)
+	int64 MaxLevelBytes = 0;
+};
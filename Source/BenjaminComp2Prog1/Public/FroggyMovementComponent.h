@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WorldCollision.h"
+#include "FroggyMovementComponent.generated.h"
+
+/**
+ * Froggy's movement component. Without bUseLightweightMovement it's exactly UCharacterMovementComponent.
+ *
+ * With it (meant for ambient NPC Froggies walking around on the navmesh), the component stops ticking on its own
+ * while it's AI controlled on the server, and UFroggyMovementSubsystem moves it together with all the others:
+ *
+ * - Kinematic: velocity comes from path following (RequestDirectMove) or AddMovementInput, same as before - so Move()
+ *   and AI MoveTo work unchanged. MaxWalkSpeed, MaxAcceleration, BrakingDecelerationWalking, bOrientRotationToMovement
+ *   and RotationRate are respected. The path keeps Froggy off the walls, there's no collision sweep at all.
+ * - Cheap ground snapping: Froggy stands on a floor plane (point + normal). A new plane comes from a single async
+ *   line trace after every GroundSampleDistance travelled - not a capsule sweep every frame.
+ * - The math for all lightweight Froggies runs in one ParallelFor; only reading the inputs and setting the final
+ *   transforms is on the game thread.
+ *
+ * Whenever the simple model doesn't fit - no floor or an unwalkable one under Froggy, root motion, a player takes
+ * over, a client's copy, "Froggy.Movement.Lightweight 0" - the full character movement takes over again, from
+ * wherever Froggy is.
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UFroggyMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Opt in to the batched, kinematic movement while AI controlled. For NPCs that just walk around on the navmesh. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Froggy|Movement")
+	bool bUseLightweightMovement = false;
+
+	/** How far (cm) a lightweight Froggy walks on one floor sample before it traces for the next one. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Froggy|Movement", meta = (EditCondition = "bUseLightweightMovement"))
+	float GroundSampleDistance = 50.0f;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Does the lightweight movement fit right now? Checked by UFroggyMovementSubsystem every frame. */
+	bool CanUseLightweightMovement() const;
+
+	bool IsLightweightActive() const { return bLightweightActive; }
+
+	/** Switches between the batched movement and the normal component tick. */
+	void SetLightweightActive(bool bActive);
+
+	// The three steps of a lightweight move, see UFroggyMovementSubsystem::Tick
+	/** Game thread: picks up this frame's input / requested velocity. */
+	void PrepareLightweightMove(float DeltaTime);
+
+	/** Any thread: works out the new velocity, location and rotation. Only touches this component's plain members. */
+	void ComputeLightweightMove();
+
+	/** Game thread: moves the capsule (no sweep) and asks for a new floor sample when it's due. */
+	void ApplyLightweightMove();
+
+private:
+	void RequestFloorSample();
+	void OnFloorSampleDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	/** Takes the floor from a hit. False if there's nothing walkable. */
+	bool SetFloor(const FHitResult& Hit);
+
+	bool bLightweightActive = false;
+	bool bLostFloor = false; // Nothing walkable under Froggy - the full movement takes over
+	double ResumeLightweightTime = 0.0; // After losing the floor, the full movement gets a moment to find a new one
+
+	// The floor plane Froggy stands on
+	FVector FloorPoint = FVector::ZeroVector;
+	FVector FloorNormal = FVector::UpVector;
+	FVector LastFloorSampleLocation = FVector::ZeroVector;
+	FTraceHandle FloorSampleHandle;
+
+	// Read on the game thread in PrepareLightweightMove, used by ComputeLightweightMove
+	struct FLightweightMove
+	{
+		float DeltaTime = 0.0f;
+		FVector Location = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+		FVector Velocity = FVector::ZeroVector;
+		FVector Input = FVector::ZeroVector;
+		FVector RequestedVelocity = FVector::ZeroVector;
+		bool bHasRequestedVelocity = false;
+		bool bOrientToMovement = false;
+		float MaxSpeed = 0.0f;
+		float MaxAcceleration = 0.0f;
+		float BrakingDeceleration = 0.0f;
+		float MaxYawStep = 0.0f;	// Negative = turn instantly
+		float HalfHeight = 0.0f;
+		float Radius = 0.0f;
+
+		// Written by ComputeLightweightMove
+		FVector NewLocation = FVector::ZeroVector;
+		FRotator NewRotation = FRotator::ZeroRotator;
+		FVector NewVelocity = FVector::ZeroVector;
+	};
+	FLightweightMove Move;
+};
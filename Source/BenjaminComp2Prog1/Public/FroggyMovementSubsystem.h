@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FroggyMovementSubsystem.generated.h"
+
+class UFroggyMovementComponent;
+
+/**
+ * Moves every Froggy that's using the lightweight movement (UFroggyMovementComponent::bUseLightweightMovement) in
+ * one batch per frame, instead of one component tick each:
+ *
+ * 1. Game thread: switch components between lightweight and full movement where needed, and read this frame's
+ *    inputs (PrepareLightweightMove).
+ * 2. ParallelFor over all of them: velocity, floor snapping, rotation (ComputeLightweightMove). Plain math on each
+ *    component's own data, nothing shared.
+ * 3. Game thread: set the transforms that changed, and fire the async floor traces that are due (ApplyLightweightMove).
+ *
+ * "stat Froggy" shows the time for the whole batch and how many Froggies were in it.
+ * "Froggy.Movement.Lightweight 0" hands everyone back to the full character movement, to compare.
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UFroggyMovementSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterComponent(UFroggyMovementComponent* Component);
+	void UnregisterComponent(UFroggyMovementComponent* Component);
+
+	/** How many Froggies moved in the last batch. */
+	int32 GetNumActive() const { return ActiveComponents.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Raw pointers are fine: components always unregister in EndPlay.
+	TArray<UFroggyMovementComponent*> Components;
+
+	// The ones moving lightweight this frame. Reused every frame, so the batch doesn't allocate
+	TArray<UFroggyMovementComponent*> ActiveComponents;
+};
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "FroggySaveSubsystem.generated.h"
+
+class AInteractableItem;
+
+/** How a placed item differs from the level. One byte per item in the save file, so only ever add new bits. */
+enum class EFroggySavedItemFlags : uint8
+{
+	None		= 0,
+	PickedUp	= 1 << 0,	// Gone through PickupItem()
+	Destroyed	= 1 << 1,	// Gone through Interact() with bDestroyOnInteract
+	LightOn		= 1 << 2,	// The light state it was left in
+
+	Removed = PickedUp | Destroyed
+};
+ENUM_CLASS_FLAGS(EFroggySavedItemFlags)
+
+/** Where Froggy was, whether it was sitting, and what it had picked up. */
+struct FFroggySavedPlayer
+{
+	FString MapName;	// Without the PIE prefix
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	bool bIsSitting = false;
+
+	// The inventory, as parallel arrays (see UFroggyInventoryComponent::GetSnapshot). Empty in version 1 saves.
+	TArray<FName> InventoryIds;
+	TArray<int32> InventoryCounts;
+};
+
+/**
+ * Saves and loads world state as a small binary snapshot in Saved/SaveGames/<Slot>.fsav.
+ *
+ * Only deltas are kept: items record themselves here the moment they change (light toggled, picked up, consumed),
+ * and drop out again when they're back to how the level has them. So there's never a scan over every item - saving
+ * writes what's in this map, and the file (and the time it takes) grows with the changed items, not the level size.
+ *
+ * Items are identified by a hash of their path (level package + actor name, see MakeSaveId), which is the same on
+ * every load and unique across levels, so all levels share one map. Spawned items (pool, lightweight spawns) have no
+ * stable path and aren't saved.
+ *
+ * Loading is one file read into this map, then the level is reopened. Every placed item looks itself up while it's
+ * initialized (AInteractableItem::PostInitializeComponents), so all state is in place before anything's BeginPlay.
+ *
+ * World Partition / level streaming: the same lookup runs whenever a cell streams in, and since changes are recorded
+ * the moment they happen, a cell unloading loses nothing. This lives on the game instance, so it also outlives
+ * the world itself (travelling to another map and back keeps the state, even without saving).
+ *
+ * "Froggy.Save [Slot]" and "Froggy.Load [Slot]" in the console.
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UFroggySaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** "FSAV" and the file version. Bump the version when the layout changes, and keep reading the old ones. */
+	static constexpr uint32 FileMagic = 0x56415346;
+	// 2: the player's inventory
+	static constexpr uint16 FileVersion = 2;
+
+	/** Stable id of an actor placed in a level, or 0 for anything spawned at runtime. */
+	static uint64 MakeSaveId(const AActor* Actor);
+
+	/** Items call this when they change (server only). bRemoved = the item was just picked up / consumed. */
+	static void RecordItem(const AInteractableItem* Item, bool bRemoved);
+	void RecordItemState(const AInteractableItem* Item, bool bRemoved);
+
+	/** The saved state of a placed item, if it differs from the level. */
+	static bool FindItem(const AInteractableItem* Item, EFroggySavedItemFlags& OutFlags);
+	bool FindItemState(const AInteractableItem* Item, EFroggySavedItemFlags& OutFlags) const;
+
+	/** Hands out the loaded player state once, if it's for this world's map. (See AMyGameMode::SpawnDefaultPawnFor) */
+	bool ConsumeSavedPlayer(const UWorld* World, FFroggySavedPlayer& OutPlayer);
+
+	/** Writes the changed items and the player to the slot. */
+	UFUNCTION(BlueprintCallable, Category = "Save")
+	bool SaveGame(const FString& SlotName);
+
+	/** Reads the slot and reopens the saved map with that state. */
+	UFUNCTION(BlueprintCallable, Category = "Save")
+	bool LoadGame(const FString& SlotName);
+
+	/** Forgets all recorded state (e.g. for a new game). */
+	UFUNCTION(BlueprintCallable, Category = "Save")
+	void ResetState();
+
+	int32 GetNumChangedItems() const { return Items.Num(); }
+
+	static FString GetSlotPath(const FString& SlotName);
+
+private:
+	void WriteSnapshot(FArchive& Ar, const FFroggySavedPlayer* Player) const;
+	static bool ReadSnapshot(FArchive& Ar, TMap<uint64, EFroggySavedItemFlags>& OutItems, FFroggySavedPlayer& OutPlayer, bool& bOutHasPlayer);
+
+	// Every placed item that doesn't look like the level has it, by save id
+	TMap<uint64, EFroggySavedItemFlags> Items;
+
+	// The player state from the last load, until the pawn is spawned with it
+	FFroggySavedPlayer SavedPlayer;
+	bool bHasSavedPlayer = false;
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Profiling hooks for the Froggy gameplay code.
+ *
+ * - "stat Froggy" in the console shows the cycle counters and counters below.
+ * - The "Froggy" trace channel sends scoped CPU events and one event per interaction/pickup to Unreal Insights.
+ *   Record with e.g. -trace=default,froggy (or "Trace.Enable Froggy" at runtime).
+ *
+ * Use the FROGGY_ macros instead of the engine ones directly - they all compile to nothing in Shipping.
+ */
+
+#define FROGGY_PROFILING_ENABLED (!UE_BUILD_SHIPPING)
+
+DECLARE_STATS_GROUP(TEXT("Froggy"), STATGROUP_Froggy, STATCAT_Advanced);
+
+// Froggy
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy CheckForNearbyItems"), STAT_Froggy_CheckForNearbyItems, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy Interact"), STAT_Froggy_Interact, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy PickupAnItem"), STAT_Froggy_PickupAnItem, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy Anim (game thread)"), STAT_Froggy_AnimGameThread, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy Anim (worker)"), STAT_Froggy_AnimWorker, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy Crowd Update"), STAT_Froggy_CrowdUpdate, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Froggy Lightweight Movement"), STAT_Froggy_LightweightMovement, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+
+// Items
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Interact"), STAT_Froggy_ItemInteract, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item PickupItem"), STAT_Froggy_ItemPickup, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Behaviors"), STAT_Froggy_ItemBehaviors, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+
+// Per frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nearby Item Checks"), STAT_Froggy_NearbyChecks, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nearby Item Checks Skipped"), STAT_Froggy_NearbyChecksSkipped, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nearby Items Found"), STAT_Froggy_NearbyItemsFound, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interactions"), STAT_Froggy_Interactions, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pickups"), STAT_Froggy_Pickups, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Predicted Interactions"), STAT_Froggy_Predictions, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mispredictions"), STAT_Froggy_Mispredictions, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Crowd Tier Changes"), STAT_Froggy_CrowdTierChanges, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lightweight Movers"), STAT_Froggy_LightweightMovers, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Animated Items"), STAT_Froggy_AnimatedItems, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Audio Voices"), STAT_Froggy_AudioVoices, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Audio Commands"), STAT_Froggy_AudioCommands, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Item Lights Active"), STAT_Froggy_LightsActive, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Item Lights Fading"), STAT_Froggy_LightsFading, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Item Lights Culled"), STAT_Froggy_LightsCulled, STATGROUP_Froggy, BENJAMINCOMP2PROG1_API);
+
+UE_TRACE_CHANNEL_EXTERN(FroggyChannel, BENJAMINCOMP2PROG1_API);
+
+/** What happened to an item, for the interaction trace events. */
+enum class EFroggyTraceInteraction : uint8
+{
+	Interact,
+	Pickup,
+};
+
+namespace FroggyTrace
+{
+	/** Sends one interaction event (time, kind, item name and location) on the Froggy trace channel. */
+	BENJAMINCOMP2PROG1_API void OutputInteraction(EFroggyTraceInteraction Kind, const AActor* Item);
+}
+
+#if FROGGY_PROFILING_ENABLED
+
+// Times the rest of the scope in "stat Froggy" and as a CPU event on the Froggy trace channel.
+#define FROGGY_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#Stat, FroggyChannel)
+
+#define FROGGY_INC_COUNTER(Stat, Amount) INC_DWORD_STAT_BY(Stat, Amount)
+
+#define FROGGY_TRACE_INTERACTION(Kind, Item) FroggyTrace::OutputInteraction(Kind, Item)
+
+#else
+
+#define FROGGY_SCOPE_CYCLE_COUNTER(Stat)
+#define FROGGY_INC_COUNTER(Stat, Amount)
+#define FROGGY_TRACE_INTERACTION(Kind, Item)
+
+#endif // FROGGY_PROFILING_ENABLED
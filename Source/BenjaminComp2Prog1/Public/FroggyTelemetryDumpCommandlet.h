@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FroggyTelemetryDumpCommandlet.generated.h"
+
+/**
+ * Reads a Froggy telemetry file (.ftel) and prints a summary: how long it covers and how many of each event.
+ * With -Csv=<path> it also writes every record out as CSV, for a spreadsheet or a quick script.
+ *
+ *   UnrealEditor-Cmd BenjaminComp2Prog1.uproject -run=FroggyTelemetryDump -File=<path> [-Csv=<path>]
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UFroggyTelemetryDumpCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFroggyTelemetryDumpCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpscRingBuffer.h"
+#include "FroggyTelemetrySubsystem.generated.h"
+
+class FFroggyTelemetryWriter;
+class FRunnableThread;
+
+/** The kinds of gameplay events we record. Stored as one byte in the file, so only ever add to the end. */
+enum class EFroggyTelemetryEvent : uint8
+{
+	Interact,
+	Pickup,
+	LightToggle,	// Value = 1 for on, 0 for off
+	Sit,			// Value = 1 for sitting down, 0 for standing up
+	HoldInteract,	// Value = how long the interact button was held, in seconds
+
+	Count
+};
+
+BENJAMINCOMP2PROG1_API const TCHAR* LexToString(EFroggyTelemetryEvent Event);
+
+/** One event, exactly as it's written to the file. Fixed size, no strings - cheap to copy into the ring buffer. */
+struct FFroggyTelemetryRecord
+{
+	uint64 Cycles = 0;		// FPlatformTime::Cycles64() when it happened
+	uint32 ActorId = 0;		// UObject unique id of the actor involved (only unique within one run)
+	uint8 Event = 0;		// EFroggyTelemetryEvent
+	uint8 Padding[3] = {};
+	float X = 0.0f;			// Where the actor was
+	float Y = 0.0f;
+	float Z = 0.0f;
+	float Value = 0.0f;		// Event specific, see EFroggyTelemetryEvent
+};
+static_assert(sizeof(FFroggyTelemetryRecord) == 32, "The telemetry file format expects 32 byte records");
+
+/** Start of every telemetry file. The records follow right after it. */
+struct FFroggyTelemetryFileHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x4C455446; // "FTEL"
+	static constexpr uint16 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint16 Version = CurrentVersion;
+	uint16 RecordSize = sizeof(FFroggyTelemetryRecord);
+	double CyclesPerSecond = 0.0;	// To turn Cycles into seconds
+	uint64 StartCycles = 0;			// Cycles when the file was started
+};
+static_assert(sizeof(FFroggyTelemetryFileHeader) == 24, "The telemetry file format expects a 24 byte header");
+
+/**
+ * Structured gameplay telemetry, without formatting strings on the game thread.
+ *
+ * Gameplay code calls Record() - that fills in a 32 byte record and pushes it into a lock-free ring buffer. That's it.
+ * A background thread empties the buffer every FlushInterval and appends the records to
+ * Saved/Telemetry/Froggy-<date>.ftel, a plain binary file (header + records).
+ *
+ * If the game thread ever outruns the writer and the buffer fills up, events are dropped (and counted) instead of
+ * stalling the game.
+ *
+ * Off unless asked for: bEnabled=True in the [/Script/BenjaminComp2Prog1.FroggyTelemetrySubsystem] section of
+ * DefaultGame.ini, or -FroggyTelemetry on the command line. Never in Shipping builds. A file stops growing at
+ * MaxFileBytes (the rest is counted as dropped), and only the newest MaxFiles files are kept.
+ *
+ * To read a file, use the commandlet:
+ *   UnrealEditor-Cmd BenjaminComp2Prog1.uproject -run=FroggyTelemetryDump -File=<path> [-Csv=<path>]
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UFroggyTelemetrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Records an event for Actor (game thread only). Does nothing if telemetry is off or Actor isn't in a game. */
+	static void Record(const AActor* Actor, EFroggyTelemetryEvent Event, float Value = 0.0f);
+
+	/** Same as Record, when you already have the subsystem. */
+	void RecordEvent(const AActor* Actor, EFroggyTelemetryEvent Event, float Value = 0.0f);
+
+	/** Reads a telemetry file back. Returns false if it's missing or not a (compatible) telemetry file. */
+	static bool ReadTelemetryFile(const FString& Path, FFroggyTelemetryFileHeader& OutHeader, TArray<FFroggyTelemetryRecord>& OutRecords);
+
+	int64 GetNumRecorded() const { return NumRecorded; }
+	int64 GetNumDropped() const { return NumDropped; }
+
+protected:
+	// Turn telemetry on/off (-FroggyTelemetry turns it on too). Ignored in Shipping, it's always off there.
+	UPROPERTY(Config)
+	bool bEnabled = false;
+
+	// One file never gets bigger than this, in bytes. 64 MB = about 2 million events.
+	UPROPERTY(Config)
+	int64 MaxFileBytes = 64 * 1024 * 1024;
+
+	// How many telemetry files are kept in Saved/Telemetry. The oldest ones are deleted when a new one starts.
+	UPROPERTY(Config)
+	int32 MaxFiles = 10;
+
+	// How many events fit in the ring buffer (rounded up to a power of two). 16k * 32 bytes = 512 KB.
+	UPROPERTY(Config)
+	int32 RingCapacity = 16384;
+
+	// How often the writer thread wakes up to empty the buffer, in seconds
+	UPROPERTY(Config)
+	float FlushInterval = 0.05f;
+
+private:
+	/** Deletes the oldest telemetry files, so there's room for a new one within MaxFiles. */
+	void DeleteOldFiles(const FString& Directory) const;
+
+	TUniquePtr<TSpscRingBuffer<FFroggyTelemetryRecord>> Ring;
+	TUniquePtr<FFroggyTelemetryWriter> Writer;
+	FRunnableThread* WriterThread = nullptr;
+
+	// Game thread only
+	int64 NumRecorded = 0;
+	int64 NumDropped = 0;
+};
@@ -4,12 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "InteractableItemArchetype.h"
 #include "InteractableItem.generated.h"
 
 class USphereComponent;
 class UStaticMeshComponent;
 class UPointLightComponent;
 class USoundBase;
+class UStaticMesh;
+class UInteractableItemArchetype;
+enum class EFroggySavedItemFlags : uint8;
 
 UCLASS()
 class BENJAMINCOMP2PROG1_API AInteractableItem : public AActor
@@ -24,14 +28,77 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the item is destroyed or removed from the world
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Placed items pick up their saved state here, before anything's BeginPlay. (See UFroggySaveSubsystem)
+	virtual void PostInitializeComponents() override;
+
+	// Called in the editor whenever the item is placed or changed - used to preview the archetype mesh.
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	// Replication. Everything here is push-model: nothing is compared unless it's marked dirty when it changes.
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void OnRep_ReplicatedMovement() override;
+
 public:	
 	// Function to handle interaction
 	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
 	void Interact();
 
-	// Function to handle Pick-up
+	// Function to handle Pick-up. True if it was picked up (false: not a pickup, already taken, or not the server).
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	bool PickupItem();
+
+	// What the item is called in an inventory: the archetype's asset name, or the class name without an archetype.
+	// Items of the same kind stack. (See UFroggyInventoryComponent)
 	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
-	void PickupItem();
+	FName GetInventoryId() const;
+
+	// Item pooling. The pool calls these instead of spawning / destroying the actor. (See UItemPoolSubsystem)
+	void DeactivateForPool();
+	void ActivateFromPool(const FTransform& Transform);
+
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	bool IsPooled() const { return bIsPooled; }
+
+	// True from the moment the item is picked up / consumed until it's actually back in the pool. (See Claim)
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	bool IsClaimed() const { return bIsClaimed; }
+
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	bool IsLightOn() const { return bLightOn; }
+
+	/**
+	 * Client-side prediction (see AFroggyCharacter::Interact / PickupAnItem). These do on the client what Interact() /
+	 * PickupItem() are about to do on the server - the light flips, the item vanishes, the sound plays - without
+	 * waiting a round trip. Returns false if there's nothing to predict (e.g. the item is already taken).
+	 */
+	bool PredictInteract();
+	bool PredictPickup();
+
+	/** The server said no: put back what PredictInteract/PredictPickup changed. The light goes back to the server's state. */
+	void RollbackPrediction(bool bWasPickup, bool bStillAvailable);
+
+	// Turns the point light on/off, same as the light toggle in Interact() does.
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	void SetLightOn(bool bNewLightOn);
+
+	// Archetype handling. The assets are loaded async by UItemArchetypeSubsystem, which then calls ApplyLoadedAssets.
+	UFUNCTION(BlueprintCallable, Category = "Bools & Interaction")
+	void SetArchetype(TSoftObjectPtr<UInteractableItemArchetype> NewArchetype);
+	
+	bool AreItemAssetsLoaded() const;
+	void GatherAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const;
+	void ApplyLoadedAssets();
+
+	// Handle of the lightweight record this actor was promoted from, or INDEX_NONE. (See ULightweightItemSubsystem)
+	int32 GetLightweightHandle() const { return LightweightHandle; }
+	void SetLightweightHandle(int32 NewHandle) { LightweightHandle = NewHandle; }
+
+	// Stable id of a placed item for save games, or 0 for spawned ones. (See UFroggySaveSubsystem::MakeSaveId)
+	uint64 GetSaveId() const { return SaveId; }
+	void SetSaveId(uint64 NewSaveId) { SaveId = NewSaveId; }
 
 	// Components
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Object Components")
@@ -46,10 +113,20 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Object Components", meta = (AllowPrivateAccess = "true"))
 	UPointLightComponent* PointLight;
 
+	// What kind of item this is: mesh, light and sound all come from the archetype data asset.
+	// Soft reference, so placing an item doesn't drag its assets into memory - the level preloads what it uses.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_Archetype, Category = "Bools & Interaction")
+	TSoftObjectPtr<UInteractableItemArchetype> Archetype;
+
+	// Mesh used when there's no archetype and a Blueprint took the default Cube off ObjectMesh. Loaded async.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bools & Interaction")
+	TSoftObjectPtr<UStaticMesh> FallbackMesh;
+
 	// Interaction Properties
 	// Add your given interaction sound to play when the object is interacted with. (on the object itself in Content Browser)
+	// Soft reference now, so the sound doesn't load together with the class. The archetype's sound replaces it.
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Bools & Interaction")
-	USoundBase* InteractionSound;
+	TSoftObjectPtr<USoundBase> InteractionSound;
 
 	// Toggle whether the object destroys itself on interact (editable from Details panel, thanks to EditAnywhere)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bools & Interaction")
@@ -63,6 +140,78 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bools & Interaction")
 	bool bIsAPickup = false;
 
+	// Should this item be stored as a cheap instance while the player is far away? It becomes a real actor again
+	// when the player comes close, but it has no point light while it's an instance.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bools & Interaction")
+	bool bUseLightweightInstancing = false;
+
+	// Idle animation (bobbing, spinning, pulsing light), done by UItemBehaviorSubsystem - the item still doesn't tick.
+	// The archetype's Behavior replaces this.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Bools & Interaction")
+	FItemBehaviorSettings Behavior;
+
 private:
+	void ApplyArchetype(const UInteractableItemArchetype* LoadedArchetype);
+
+	// Puts the item in the state a save game left it in: gone, or with its light switched.
+	void ApplySavedState(EFroggySavedItemFlags Flags);
+
+	// Hands the item back to the pool if there is one, or destroys it the old-fashioned way.
+	void RemoveFromPlay();
+
+	// The part of removing an item that can't wait: nobody else can find, pick up or interact with it, and it's
+	// hidden. The expensive part (RemoveFromPlay) is queued on the deferred work subsystem.
+	void Claim();
+
+	// The local half of DeactivateForPool: hidden, no collision, out of every subsystem. No replicated state is
+	// touched, so clients use this on their own when the server pools the item.
+	void HideForPool();
+
+	// Sound (and whatever else we add later) when the item is interacted with. Runs on the server and every client.
+	void PlayInteractionEffects();
+
+	/**
+	 * Server: call after marking a replicated property dirty. Wakes the item up from network dormancy for one
+	 * update, so clients get the change - the rest of the time idle items cost nothing per net tick.
+	 */
+	void WakeUpForReplication();
+
+	UFUNCTION()
+	void OnRep_LightOn();
+
+	UFUNCTION()
+	void OnRep_IsPooled();
+
+	UFUNCTION()
+	void OnRep_Archetype();
+
+	UFUNCTION()
+	void OnRep_InteractCount(uint8 OldCount);
+
+	UPROPERTY(ReplicatedUsing = OnRep_LightOn)
 	bool bLightOn = true;
+
+	// Client: the last bLightOn the server sent. A prediction writes bLightOn locally, and the server won't send its
+	// value again unless it changes - so a rollback has to put this back, not what we had before predicting.
+	bool bServerLightOn = true;
+
+	// True while the item is sleeping in the pool (hidden, no collision, not in the spatial hash).
+	// Replicated, so clients put their copy to sleep too.
+	UPROPERTY(ReplicatedUsing = OnRep_IsPooled)
+	bool bIsPooled = false;
+
+	// Goes up by one for every interaction on the server. Clients play the effects when it changes.
+	UPROPERTY(ReplicatedUsing = OnRep_InteractCount)
+	uint8 InteractCount = 0;
+
+	// True between Claim() and going back into the pool.
+	bool bIsClaimed = false;
+
+	// Effects this client already played for its own predicted interactions. OnRep_InteractCount skips that many of
+	// the server's interactions, so the sound doesn't play twice when the server's change arrives.
+	uint8 NumPredictedEffects = 0;
+
+	int32 LightweightHandle = INDEX_NONE;
+
+	uint64 SaveId = 0;
 };
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "InteractableItemArchetype.generated.h"
+
+class UStaticMesh;
+class USoundBase;
+
+/** Point light setup for an item archetype. Defaults match what AInteractableItem used to hard-code. */
+USTRUCT(BlueprintType)
+struct FItemLightSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Light")
+	float Intensity = 200.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Light")
+	float AttenuationRadius = 100.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Light")
+	FLinearColor Color = FLinearColor::White;
+};
+
+/**
+ * Idle animation for an item: bobbing, spinning and a pulsing light. All zero (the default) means the item sits still,
+ * like it always did. Animated by UItemBehaviorSubsystem, not by the item's own tick.
+ */
+USTRUCT(BlueprintType)
+struct FItemBehaviorSettings
+{
+	GENERATED_BODY()
+
+	/** How far (cm) the mesh bobs up and down. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0"))
+	float BobHeight = 0.0f;
+
+	/** Bobs per second. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0"))
+	float BobFrequency = 0.5f;
+
+	/** Degrees per second the mesh turns around its up axis. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Behavior")
+	float SpinSpeed = 0.0f;
+
+	/** How much (0-1) of the light's intensity pulses away and back. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0", ClampMax = "1"))
+	float PulseAmount = 0.0f;
+
+	/** Pulses per second. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Behavior", meta = (ClampMin = "0"))
+	float PulseFrequency = 1.0f;
+
+	bool IsAnimated() const { return BobHeight > 0.0f || SpinSpeed != 0.0f || PulseAmount > 0.0f; }
+};
+
+/**
+ * Describes one kind of item: what it looks like, how it sounds and how it glows.
+ *
+ * The mesh and sound are soft references, so nothing heavy is loaded just because a level (or a class) points at an
+ * archetype. They're tagged with the "Game" asset bundle, and UItemArchetypeSubsystem loads that bundle through the
+ * Asset Manager for exactly the archetypes a level uses - and unloads them again when the level goes away.
+ *
+ * Create them in the Content Browser (Miscellaneous > Data Asset > InteractableItemArchetype) under /Game/Items,
+ * which is where the Asset Manager looks for them (see [/Script/Engine.AssetManagerSettings] in DefaultGame.ini).
+ */
+UCLASS(BlueprintType)
+class BENJAMINCOMP2PROG1_API UInteractableItemArchetype : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** The Primary Asset Type all archetypes are registered under. */
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	/** The asset bundle holding the mesh and sound. */
+	static const FName GameBundle;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Visuals", meta = (AssetBundles = "Game"))
+	TSoftObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Visuals")
+	FVector MeshScale = FVector(0.5f);
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Visuals")
+	FItemLightSettings Light;
+
+	/** Replaces the item's own Behavior. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Visuals")
+	FItemBehaviorSettings Behavior;
+
+	/** Radius of the item's InteractionSphere */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Interaction")
+	float InteractionRadius = 80.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Interaction", meta = (AssetBundles = "Game"))
+	TSoftObjectPtr<USoundBase> InteractionSound;
+};
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InteractionAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+
+/** What the interaction audio did, in total since the level started. */
+USTRUCT(BlueprintType)
+struct FInteractionAudioStats
+{
+	GENERATED_BODY()
+
+	// Voices playing right now
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumVoices = 0;
+
+	// Audio components in the pool (playing or not)
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumPooled = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumRequested = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumPlayed = 0;
+
+	// Merged into another request for the same sound nearby
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumCoalesced = 0;
+
+	// Over the per-sound or global voice budget
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumDropped = 0;
+
+	// Calls that send work to the audio thread last frame: Play, and volume changes on voices that are playing
+	UPROPERTY(BlueprintReadOnly, Category = "Audio")
+	int32 NumCommandsLastFrame = 0;
+};
+
+/**
+ * Plays the item interaction sounds, instead of a fire-and-forget PlaySoundAtLocation (and a new audio component)
+ * for every single interaction.
+ *
+ * PlaySound only queues the request. Once per frame, the queue is flushed:
+ * 1. Requests for the same sound within CoalesceRadius of each other - in the same frame, or of one that started less
+ *    than CoalesceWindow ago - become one voice, a bit louder for every extra request. An area pickup of 30 coins is
+ *    one coin sound, not 30.
+ * 2. Closest to the listener first, every sound gets at most MaxVoicesPerSound voices, and all of them together at
+ *    most MaxVoices. Whatever's left over is dropped - they're short one-shots, nobody misses the 17th.
+ * 3. The survivors play on audio components from a pool, which are kept around (and registered) for the next sound.
+ *
+ * Voices are counted by the sound's duration, not by asking the audio device, so the budgets work the same with
+ * -nosound or the null audio device - which is how they're checked headless ("Froggy.Audio.Burst N" fires N
+ * requests in one frame, "Froggy.Audio.Stats" prints the counts). "stat Froggy" has voices and audio commands per
+ * frame.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UInteractionAudioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** The requests and voices aren't UPROPERTYs (plain structs), so their sounds are reported to the GC here. */
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/** Queues a one-shot at Location. It starts at the end of the frame - or gets merged with another, or dropped. */
+	void PlaySound(USoundBase* Sound, const FVector& Location);
+
+	UFUNCTION(BlueprintCallable, Category = "Audio")
+	FInteractionAudioStats GetStats() const { return Stats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// The sounds are held strongly (see AddReferencedObjects): a queued request is only played at the end of the
+	// frame, and nothing else has to keep its sound loaded until then.
+	struct FSoundRequest
+	{
+		TObjectPtr<USoundBase> Sound;
+		FVector Location = FVector::ZeroVector;
+		int32 Count = 1;
+		float DistanceSquared = 0.0f; // To the listener
+	};
+
+	struct FVoice
+	{
+		UAudioComponent* Component = nullptr;
+		TObjectPtr<USoundBase> Sound;
+		FVector Location = FVector::ZeroVector;
+		double StartTime = 0.0;
+		double EndTime = 0.0;
+		int32 Count = 1; // Requests merged into this voice
+	};
+
+	/** Steps 1-3 above. */
+	void FlushRequests();
+
+	/** Merges the request into a recent voice of the same sound nearby. False if there's none. */
+	bool CoalesceWithVoice(const FSoundRequest& Request, double Now);
+
+	void StartVoice(const FSoundRequest& Request, double Now);
+
+	/** A free pooled component, or a new one if the pool is all in use. Null once the pool has MaxVoices. */
+	UAudioComponent* GetFreeComponent();
+
+	float GetVolumeMultiplier(int32 Count) const;
+
+	/** Requests for the same sound closer than this (cm) are merged. */
+	UPROPERTY(Config)
+	float CoalesceRadius = 400.0f;
+
+	/** A request also merges into a voice of the same sound that started less than this many seconds ago. */
+	UPROPERTY(Config)
+	float CoalesceWindow = 0.05f;
+
+	/** Every merged request adds this much volume, up to MaxCoalescedVolume. */
+	UPROPERTY(Config)
+	float CoalescedVolumeStep = 0.1f;
+
+	UPROPERTY(Config)
+	float MaxCoalescedVolume = 1.5f;
+
+	UPROPERTY(Config)
+	int32 MaxVoicesPerSound = 4;
+
+	/** All interaction sounds together. Also the most audio components the pool will make. */
+	UPROPERTY(Config)
+	int32 MaxVoices = 16;
+
+	/** How long a looping (or unknown length) sound counts as a voice. */
+	UPROPERTY(Config)
+	float MaxVoiceDuration = 5.0f;
+
+	// Holds the pooled audio components. Spawned on the first sound, so worlds without any sound don't get one.
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> PoolActor;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> Pool;
+
+	// The pooled components no voice is using right now
+	TArray<UAudioComponent*> FreeComponents;
+
+	TArray<FVoice> Voices;
+	TArray<FSoundRequest> Requests;
+
+	// Reused every flush, so it doesn't allocate
+	TArray<FSoundRequest> Merged;
+
+	int32 NumCommands = 0;
+
+	FInteractionAudioStats Stats;
+};
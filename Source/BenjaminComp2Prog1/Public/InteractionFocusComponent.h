@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
+#include "InteractionFocusComponent.generated.h"
+
+class AInteractableItem;
+
+/**
+ * Picks the item the owner should interact with: the best scored one in range, not just whatever overlap came first.
+ *
+ * Every UpdateInterval the candidate set is brought up to date with the spatial hash - items that came into
+ * FocusRadius are added, the ones that left are removed. If the owner didn't move and no item was added/moved,
+ * even that is skipped. The candidates' positions are kept as separate X/Y/Z arrays (structure-of-arrays), so
+ * scoring them is one SIMD pass, four candidates at a time:
+ *
+ *   Score = DistanceWeight * (1 - Distance / FocusRadius) + FacingWeight * dot(OwnerForward, DirectionToItem)
+ *
+ * So close items in front of Froggy win over close items behind it. Call SelectBestTarget() when you're about to
+ * interact - it re-scores right away, so the pick matches where Froggy is looking at that moment.
+ *
+ * With Froggy.Interaction.QueryMode set to physics, the items in range come from an overlap on the Interactable
+ * channel instead of the spatial hash. In async mode that overlap is answered a frame later.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class BENJAMINCOMP2PROG1_API UInteractionFocusComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionFocusComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Updates the candidates, scores them now and returns the best one (nullptr if nothing is in range). */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	AInteractableItem* SelectBestTarget();
+
+	/** The best scored item as of the last update. Cheap - doesn't re-score. */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	AInteractableItem* GetFocusedItem() const { return FocusedItem.Get(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	int32 GetNumCandidates() const { return Candidates.Num(); }
+
+	// Items further away than this from the owner can't be focused
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	float FocusRadius = 190.0f;
+
+	// How much being close counts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	float DistanceWeight = 1.0f;
+
+	// How much being in front of the owner counts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	float FacingWeight = 0.5f;
+
+	// How often the candidates are refreshed and re-scored, in seconds
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	float UpdateInterval = 0.05f;
+
+private:
+	/**
+	 * Looks for the items in range (how depends on Froggy.Interaction.QueryMode) and passes them to SetCandidates.
+	 * Skipped if nothing could have changed. In async mode the answer arrives next frame, in OnAsyncQueryDone.
+	 */
+	void UpdateCandidates();
+	void OnAsyncQueryDone(const FTraceHandle& Handle, FOverlapDatum& Datum);
+
+	/** Adds the items that came into range, drops the ones that left. */
+	void SetCandidates(const TArray<AInteractableItem*>& InRange);
+
+	/** Scores every candidate (SIMD) and stores the winner in FocusedItem. */
+	void UpdateFocus();
+
+	void AddCandidate(AInteractableItem* Item, const FVector& Location);
+	void RemoveCandidateAt(int32 Index);
+
+	// The candidates, structure-of-arrays. Same index = same candidate in all of them.
+	TArray<TObjectKey<AInteractableItem>> Candidates;
+	TArray<float> CandidateX;
+	TArray<float> CandidateY;
+	TArray<float> CandidateZ;
+	TArray<float> Scores; // Scratch space for UpdateFocus
+
+	// Item -> index in the arrays above, so adding/removing doesn't need a search
+	TMap<TObjectKey<AInteractableItem>, int32> CandidateIndices;
+
+	TWeakObjectPtr<AInteractableItem> FocusedItem;
+
+	// What the candidate set was built from, to know when it can't have changed
+	FVector LastUpdateLocation = FVector::ZeroVector;
+	uint32 LastUpdateRevision = 0;
+	float LastUpdateRadius = 0.0f;
+	bool bHasCandidates = false;
+
+	// The async overlap in flight, if any
+	FTraceHandle AsyncQueryHandle;
+};
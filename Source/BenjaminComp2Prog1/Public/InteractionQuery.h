@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+
+class AInteractableItem;
+
+/**
+ * The "Interactable" trace channel (Project Settings > Collision, see DefaultEngine.ini). Everything ignores it by
+ * default - only an item's InteractionSphere overlaps it, so physics queries on it only ever find items.
+ */
+#define ECC_Interactable ECC_GameTraceChannel1
+
+/** How Froggy finds items for pickups and interaction. Switch with Froggy.Interaction.QueryMode. */
+enum class EInteractionQueryMode : uint8
+{
+	SpatialHash,	// 0: Ask UItemSpatialHashSubsystem. No physics at all.
+	SyncPhysics,	// 1: Overlap/sweep on the Interactable channel, right now, on the game thread.
+	AsyncPhysics,	// 2: Same queries through the async trace API. Results come in next frame.
+};
+
+/**
+ * Helpers for finding items with physics queries on the Interactable channel.
+ *
+ * Physics finds every InteractionSphere the query shape touches, but the spatial hash only looks at item centers.
+ * So physics results are filtered down to items whose center is within Radius too - all three modes find the same
+ * items, they only differ in cost and timing.
+ */
+namespace InteractionQuery
+{
+	BENJAMINCOMP2PROG1_API EInteractionQueryMode GetMode();
+
+	/** Items with their center within Radius of Center. */
+	BENJAMINCOMP2PROG1_API void OverlapItems(const UWorld* World, const FVector& Center, float Radius, const AActor* IgnoredActor, TArray<AInteractableItem*>& OutItems);
+
+	/** Items with their center within Radius of the segment Start -> End. */
+	BENJAMINCOMP2PROG1_API void SweepItems(const UWorld* World, const FVector& Start, const FVector& End, float Radius, const AActor* IgnoredActor, TArray<AInteractableItem*>& OutItems);
+
+	/** Async version of OverlapItems. Delegate runs next frame; turn the result into items with GetOverlapResultItems. */
+	BENJAMINCOMP2PROG1_API FTraceHandle AsyncOverlapItems(UWorld* World, const FVector& Center, float Radius, const AActor* IgnoredActor, const FOverlapDelegate& Delegate);
+
+	/** Async version of SweepItems. Delegate runs next frame; turn the result into items with GetSweepResultItems. */
+	BENJAMINCOMP2PROG1_API FTraceHandle AsyncSweepItems(UWorld* World, const FVector& Start, const FVector& End, float Radius, const AActor* IgnoredActor, const FTraceDelegate& Delegate);
+
+	/** The items from a finished AsyncOverlapItems, with the same center-within-Radius filter as OverlapItems. */
+	BENJAMINCOMP2PROG1_API void GetOverlapResultItems(const FOverlapDatum& Datum, float Radius, TArray<AInteractableItem*>& OutItems);
+
+	/** The items from a finished AsyncSweepItems, with the same filter as SweepItems. */
+	BENJAMINCOMP2PROG1_API void GetSweepResultItems(const FTraceDatum& Datum, float Radius, TArray<AInteractableItem*>& OutItems);
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ItemArchetypeSubsystem.generated.h"
+
+class AInteractableItem;
+class UInteractableItemArchetype;
+struct FStreamableHandle;
+
+/**
+ * Loads item archetypes (and their mesh/sound bundle) for the current level, asynchronously.
+ *
+ * When the level starts, it looks at which archetypes the placed items use and asks the Asset Manager to load only
+ * those, as one batch. Items call RequestItemAssets in BeginPlay and get their archetype applied as soon as it's in.
+ * When the world goes away, everything this level loaded is unloaded again.
+ *
+ * Items without an archetype load their FallbackMesh / InteractionSound the same async way, just without the
+ * Asset Manager (there's no Primary Asset to track).
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UItemArchetypeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Starts loading these archetypes (with their "Game" bundle), e.g. ahead of spawning items that use them. */
+	UFUNCTION(BlueprintCallable, Category = "Item Archetypes")
+	void PreloadArchetypes(const TArray<FPrimaryAssetId>& ArchetypeIds);
+
+	/** Lets go of archetypes this level doesn't need anymore. Items still using them keep their current mesh. */
+	UFUNCTION(BlueprintCallable, Category = "Item Archetypes")
+	void UnloadArchetypes(const TArray<FPrimaryAssetId>& ArchetypeIds);
+
+	/** Applies the item's archetype (or fallback assets) right away if loaded, or as soon as the load finishes. */
+	void RequestItemAssets(AInteractableItem* Item);
+
+	/** Starts loading what an item of ItemClass with Archetype would need, without having an actor yet. */
+	void PreloadItemAssets(TSubclassOf<AInteractableItem> ItemClass, const TSoftObjectPtr<UInteractableItemArchetype>& Archetype);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** The Primary Asset Id of an archetype, or an invalid id if it isn't registered with the Asset Manager. */
+	static FPrimaryAssetId GetArchetypeId(const TSoftObjectPtr<UInteractableItemArchetype>& Archetype);
+
+	void LoadSoftAssets(TArray<FSoftObjectPath>&& Paths);
+
+	/**
+	 * Runs OnAssetsLoaded next tick. Every load completion goes through here, including loads that complete right
+	 * away (everything already in memory), so an item is never applied from inside its own RequestItemAssets call.
+	 */
+	void ScheduleRetry();
+	void OnAssetsLoaded();
+
+	/** True while the Asset Manager is still loading this archetype. */
+	bool IsArchetypeLoading(const FPrimaryAssetId& ArchetypeId) const;
+
+	// Archetypes this world asked the Asset Manager for - all unloaded again in Deinitialize
+	TSet<FPrimaryAssetId> LoadedArchetypes;
+
+	// Their load handles. Weak, since the Asset Manager owns them (and a strong one would keep them loaded).
+	TMap<FPrimaryAssetId, TWeakPtr<FStreamableHandle>> ArchetypeLoads;
+
+	bool bRetryScheduled = false;
+
+	// Fallback / unregistered loads; the handles keep the assets in memory
+	TArray<TSharedPtr<FStreamableHandle>> StreamableHandles;
+
+	// Items waiting for their assets
+	TArray<TWeakObjectPtr<AInteractableItem>> PendingItems;
+
+	// How often each pending item went through a load, so a broken path can't keep us looping forever
+	TMap<TObjectKey<AInteractableItem>, int32> LoadAttempts;
+};
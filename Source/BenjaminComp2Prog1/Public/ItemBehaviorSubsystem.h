@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InteractableItemArchetype.h"
+#include "ItemBehaviorSubsystem.generated.h"
+
+class AInteractableItem;
+
+/**
+ * Animates items (bobbing, spinning, pulsing lights - see FItemBehaviorSettings) without turning on their Tick.
+ *
+ * Every animated item is one slot in a handful of flat arrays (settings, where it is, its results), and a frame is:
+ * 1. One ParallelFor over all of them: is it close enough to the view, and what's its offset, yaw and light scale at
+ *    this time. Plain math on the arrays, no actors touched.
+ * 2. Game thread: push the results to the mesh and light of the items that are close and on screen.
+ *
+ * The animation is a function of the world time, not accumulated, so skipping items (far away, not rendered, hidden)
+ * costs nothing and they're right where they should be when they come back.
+ *
+ * Pulsing goes through the light budget (UItemLightBudgetSubsystem::SetIntensityScale) when there is one, since it
+ * owns the light's intensity.
+ *
+ * Only items with something to animate are registered, so a level full of still items costs nothing here.
+ * "Froggy.Items.Behaviors 0" stops (and resets) all the animation, "stat Froggy" has the cost.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UItemBehaviorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Starts animating the item with its Behavior, or picks up new settings / a new location if it's already
+	 * animated. Items with nothing to animate are unregistered instead.
+	 */
+	void RegisterItem(AInteractableItem* Item);
+
+	/** Stops animating the item and puts its mesh and light back where they were. */
+	void UnregisterItem(AInteractableItem* Item);
+
+	int32 GetNumRegistered() const { return Items.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void RemoveAt(int32 Index);
+
+	/** Mesh offset and yaw (on top of the rest pose) and light scale, for ApplyResults. */
+	struct FBehaviorResult
+	{
+		FVector3f Offset = FVector3f::ZeroVector;
+		float Yaw = 0.0f;
+		float LightScale = 1.0f;
+		bool bVisible = false; // Close enough to the view to bother
+	};
+
+	/** Items further than this from the view aren't animated. */
+	UPROPERTY(Config)
+	float MaxBehaviorDistance = 4000.0f;
+
+	// Structure of arrays, all indexed the same. Raw pointers are fine: items always unregister in EndPlay / when pooled.
+	TArray<AInteractableItem*> Items;
+	TArray<FItemBehaviorSettings> Settings;
+	TArray<FVector3f> Locations;		// Item location, for the distance check
+	TArray<float> Phases;				// Seconds, so neighbouring items don't bob in lockstep
+	TArray<FVector> RestLocations;		// Mesh relative location/yaw before any animation
+	TArray<FRotator> RestRotations;
+	TArray<float> RestIntensities;		// Without a light budget, the pulse scales this
+	TArray<TEnumAsByte<ECollisionEnabled::Type>> RestCollision; // Mesh collision before we turned it off for moving it
+	TArray<FBehaviorResult> Results;
+
+	TMap<AInteractableItem*, int32> ItemIndices;
+
+	bool bWasEnabled = true;
+};
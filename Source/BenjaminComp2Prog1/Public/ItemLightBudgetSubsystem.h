@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemLightBudgetSubsystem.generated.h"
+
+class AInteractableItem;
+class UPointLightComponent;
+
+/** How the light budget was spent this frame. */
+USTRUCT(BlueprintType)
+struct FItemLightBudgetStats
+{
+	GENERATED_BODY()
+
+	// Lights registered with the budget (every live item has one)
+	UPROPERTY(BlueprintReadOnly, Category = "Light Budget")
+	int32 NumRegistered = 0;
+
+	// Lights that are visible right now (including the ones still fading in or out)
+	UPROPERTY(BlueprintReadOnly, Category = "Light Budget")
+	int32 NumActive = 0;
+
+	// Lights that want to be on (bLightOn) but didn't make the cut
+	UPROPERTY(BlueprintReadOnly, Category = "Light Budget")
+	int32 NumCulled = 0;
+
+	// Lights between fully on and fully off
+	UPROPERTY(BlueprintReadOnly, Category = "Light Budget")
+	int32 NumFading = 0;
+};
+
+/**
+ * Keeps the number of dynamic item lights in check.
+ *
+ * Every frame all registered item lights get a score, based on how close they are to the camera and how much of
+ * the screen they're likely to cover. Only the best MaxActiveLights of the ones that are switched on (bLightOn) get
+ * to shine; the rest fade out. Lights fade in and out over FadeTime instead of popping.
+ *
+ * Scoring happens first, and then all intensity/visibility changes are pushed to the light components in one go at
+ * the end of the frame, only for the lights whose values actually changed.
+ *
+ * Items still own whether their light is on (Interact() toggles bLightOn) - the budget only decides whether a light
+ * that is on can actually be seen. Use "Froggy.Lights.Stats" in the console for the counts.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UItemLightBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Hands the item's point light over to the budget. It starts hidden and fades in once it ranks high enough. */
+	void RegisterItem(AInteractableItem* Item);
+
+	/** Gives the light back (hidden and at full intensity), e.g. when the item is pooled or destroyed. */
+	void UnregisterItem(AInteractableItem* Item);
+
+	/** Call this if the item's light intensity was changed from outside, so fading scales the new value. */
+	void SetBaseIntensity(AInteractableItem* Item, float NewIntensity);
+
+	/** Multiplies the light's intensity on top of the fade, e.g. for pulsing (see UItemBehaviorSubsystem). 1 = as is. */
+	void SetIntensityScale(AInteractableItem* Item, float Scale);
+
+	UFUNCTION(BlueprintCallable, Category = "Light Budget")
+	FItemLightBudgetStats GetStats() const { return Stats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FManagedLight
+	{
+		AInteractableItem* Item = nullptr;
+		UPointLightComponent* Light = nullptr;
+		float BaseIntensity = 0.0f;
+		float IntensityScale = 1.0f;
+
+		float Alpha = 0.0f;         // 0 = off, 1 = full intensity
+		float AppliedAlpha = -1.0f; // What the component last got, so unchanged lights aren't touched
+		float AppliedScale = 1.0f;
+		bool bInBudget = false;     // Made the cut this frame
+	};
+
+	bool GetViewPoint(FVector& OutLocation, FVector& OutDirection) const;
+	float ScoreLight(const FManagedLight& Managed, const FVector& ViewLocation, const FVector& ViewDirection) const;
+
+	/** How many item lights may be visible at the same time. */
+	UPROPERTY(Config)
+	int32 MaxActiveLights = 16;
+
+	/** Seconds it takes a light to fade fully in or out. */
+	UPROPERTY(Config)
+	float FadeTime = 0.3f;
+
+	/** Lights further than this from the camera are never considered. */
+	UPROPERTY(Config)
+	float MaxLightDistance = 5000.0f;
+
+	/** Score bonus for lights that are already in the budget, so two close lights don't keep swapping places. */
+	UPROPERTY(Config)
+	float KeepActiveBias = 1.1f;
+
+	// Raw pointers are fine: items always unregister in EndPlay / when pooled.
+	TArray<FManagedLight> Lights;
+	TMap<AInteractableItem*, int32> LightIndices;
+
+	// Reused every frame, so ranking doesn't allocate
+	TArray<TPair<float, int32>> RankedLights;
+
+	FItemLightBudgetStats Stats;
+};
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPoolSubsystem.generated.h"
+
+class AInteractableItem;
+
+/** The free list for one item class. (Wrapped in a struct, because UPROPERTY TMaps can't hold TArrays directly.) */
+USTRUCT()
+struct FItemPoolFreeList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AInteractableItem>> Items;
+};
+
+/** Hit/miss counters, so we can check that steady-state play doesn't spawn anything. */
+USTRUCT(BlueprintType)
+struct FItemPoolStats
+{
+	GENERATED_BODY()
+
+	// AcquireItem calls that got an item back from the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Item Pool")
+	int32 Hits = 0;
+
+	// AcquireItem calls that had to spawn a new actor
+	UPROPERTY(BlueprintReadOnly, Category = "Item Pool")
+	int32 Misses = 0;
+
+	// Items handed back to the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Item Pool")
+	int32 Releases = 0;
+
+	// Items currently sleeping in the pool, across all classes
+	UPROPERTY(BlueprintReadOnly, Category = "Item Pool")
+	int32 NumPooled = 0;
+};
+
+/**
+ * Actor pool for AInteractableItems.
+ *
+ * Instead of Destroy()ing picked up / consumed items (which leaves garbage for the GC to chew on), items are put to
+ * sleep: hidden, collision off, light off, state reset - and stored in a free list per class.
+ * The next AcquireItem for that class wakes one up instead of paying for a full actor spawn with all its components.
+ *
+ * Use "Froggy.Pool.Stats" in the console to print the hit/miss counters.
+ */
+UCLASS()
+class BENJAMINCOMP2PROG1_API UItemPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Returns an active item of ItemClass at Transform - recycled from the pool if possible, spawned if not. */
+	UFUNCTION(BlueprintCallable, Category = "Item Pool", meta = (DeterminesOutputType = "ItemClass"))
+	AInteractableItem* AcquireItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform);
+
+	/** Deactivates the item and puts it in the free list of its class (unless it belongs to a streaming level/cell). */
+	UFUNCTION(BlueprintCallable, Category = "Item Pool")
+	void ReleaseItem(AInteractableItem* Item);
+
+	/** Spawns Count sleeping items of ItemClass up front, so the first pickups of a level don't pay for spawning. */
+	UFUNCTION(BlueprintCallable, Category = "Item Pool")
+	void Prewarm(TSubclassOf<AInteractableItem> ItemClass, int32 Count);
+
+	UFUNCTION(BlueprintCallable, Category = "Item Pool")
+	FItemPoolStats GetStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Item Pool")
+	void ResetStats();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	AInteractableItem* SpawnItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform) const;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AInteractableItem>, FItemPoolFreeList> FreeLists;
+
+	int32 Hits = 0;
+	int32 Misses = 0;
+	int32 Releases = 0;
+};
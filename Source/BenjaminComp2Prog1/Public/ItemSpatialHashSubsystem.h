@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "ItemSpatialHashSubsystem.generated.h"
+
+class AInteractableItem;
+
+/**
+ * Keeps every AInteractableItem in the world inside a uniform grid (see TSpatialHashGrid), so "which items are
+ * near Froggy?" is answered by looking at a few grid cells instead of walking physics overlaps.
+ *
+ * Items register themselves in BeginPlay and unregister in EndPlay (which also runs when they are Destroy()ed).
+ * One of these exists per game world automatically - grab it with GetWorld()->GetSubsystem<UItemSpatialHashSubsystem>().
+ *
+ * CellSize can be tweaked in DefaultGame.ini under [/Script/BenjaminComp2Prog1.ItemSpatialHashSubsystem].
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API UItemSpatialHashSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Adds the item at its current location (or moves it, if it's already registered). */
+	void RegisterItem(AInteractableItem* Item);
+
+	/** Removes the item from the grid. Safe to call for items that were never registered. */
+	void UnregisterItem(AInteractableItem* Item);
+
+	/** Call this if an item moves after BeginPlay, so the grid knows about the new location. */
+	void UpdateItem(AInteractableItem* Item);
+
+	/** Finds every registered item within Radius of Center (in no particular order). */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void QueryItemsInRadius(const FVector& Center, float Radius, TArray<AInteractableItem*>& OutItems) const;
+
+	/** Finds every registered item within Radius of the path Start -> End, i.e. everything a sphere moving along it touched. */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void QueryItemsAlongPath(const FVector& Start, const FVector& End, float Radius, TArray<AInteractableItem*>& OutItems) const;
+
+	/** Finds up to MaxCount registered items within Radius of Center, closest first. */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void QueryNearestItems(const FVector& Center, float Radius, int32 MaxCount, TArray<AInteractableItem*>& OutItems) const;
+
+	/** Returns the closest registered item within Radius of Center, or nullptr if there is none. */
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	AInteractableItem* FindNearestItem(const FVector& Center, float Radius) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	int32 GetNumItems() const { return Grid.Num(); }
+
+	/** Memory the grid holds, for the benchmarks. */
+	SIZE_T GetAllocatedSize() const { return Grid.GetAllocatedSize(); }
+
+	/**
+	 * Goes up every time an item is added or moved. If it's the same as last time you looked (and you didn't move),
+	 * no new item can have shown up around you - so there's no need to query again.
+	 */
+	uint32 GetRevision() const { return Revision; }
+
+protected:
+	// Only real game worlds (and PIE) have items running BeginPlay; editor preview worlds don't need a grid.
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Size of one grid cell in cm. Roughly the size of the usual query radius works best. */
+	UPROPERTY(Config)
+	float CellSize = 400.0f;
+
+	// Raw pointers are fine here: items always unregister in EndPlay, before they can be garbage collected.
+	TSpatialHashGrid<AInteractableItem*> Grid;
+
+	// See GetRevision. Removing items doesn't bump it - that can't put anything new in reach.
+	uint32 Revision = 0;
+};
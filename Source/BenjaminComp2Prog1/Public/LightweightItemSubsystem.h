@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "LightweightItemSubsystem.generated.h"
+
+class AInteractableItem;
+class UInteractableItemArchetype;
+class UHierarchicalInstancedStaticMeshComponent;
+class USoundBase;
+class UStaticMesh;
+
+/**
+ * An item that is (currently) just data: where it is, what it is, and the state it was left in.
+ * While it's far from the player it's drawn as one instance of a shared HISM, and has no actor at all.
+ */
+USTRUCT()
+struct FLightweightItem
+{
+	GENERATED_BODY()
+
+	// Which actor class to promote into
+	UPROPERTY()
+	TSubclassOf<AInteractableItem> ItemClass;
+
+	UPROPERTY()
+	TSoftObjectPtr<UInteractableItemArchetype> Archetype;
+
+	// Mesh of the item, which decides the HISM it's drawn with. Null until the archetype / fallback mesh is loaded.
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY()
+	TSoftObjectPtr<USoundBase> InteractionSound;
+
+	// The real actor, while the item is promoted
+	UPROPERTY()
+	TObjectPtr<AInteractableItem> Actor;
+
+	FTransform Transform;       // Actor transform
+	FTransform MeshTransform;   // ObjectMesh relative transform (the 0.5 scale of the cube, etc.)
+
+	// Index in the group's HISM, INDEX_NONE while not drawn, or PendingInstanceIndex while it waits for the next batch
+	int32 InstanceIndex = INDEX_NONE;
+	static constexpr int32 PendingInstanceIndex = -2;
+
+	uint64 SaveId = 0;          // Save game id of the placed item this came from (0 = not saved)
+
+	bool bDestroyOnInteract = false;
+	bool bToggleLight = false;
+	bool bIsAPickup = false;
+	bool bLightOn = true;
+
+	bool bInUse = false;
+};
+
+/** All lightweight items sharing one mesh get drawn by one HISM component. */
+USTRUCT()
+struct FLightweightItemMeshGroup
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Instances;
+
+	// Instance slots that are hidden (scaled to zero) and can be reused. Instances are never removed, since
+	// removing shuffles the indices of other instances around, and then we'd have to fix up every item.
+	TArray<int32> FreeInstances;
+
+	// New instances waiting to be added in one AddInstances call (see FlushPendingInstances), and whose they are
+	TArray<FTransform> PendingTransforms;
+	TArray<int32> PendingHandles;
+
+	bool bRenderStateDirty = false;
+};
+
+/**
+ * Keeps far-away AInteractableItems as plain data, drawn through one HISM per mesh, so 100k items
+ * cost a handful of draw calls and no per-actor game-thread work.
+ *
+ * Every CheckInterval the subsystem looks around each player's Froggy:
+ * - Lightweight items within PromoteRadius become real AInteractableItems (taken from UItemPoolSubsystem), so
+ *   Interact() and PickupItem() work exactly as before.
+ * - Promoted items further away than DemoteRadius from every player go back to being an instance, keeping the
+ *   state (e.g. light toggled off) they were left in.
+ * DemoteRadius is a bit bigger than PromoteRadius so items at the edge don't flicker between the two.
+ *
+ * Placed items opt in with bUseLightweightInstancing, or items can be added straight as data with AddLightweightItem.
+ * Note: lightweight items have no point light - lights only exist on promoted items.
+ */
+UCLASS(Config=Game)
+class BENJAMINCOMP2PROG1_API ULightweightItemSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an item as pure data, using the defaults of ItemClass. Returns a handle for RemoveLightweightItem. */
+	UFUNCTION(BlueprintCallable, Category = "Lightweight Items")
+	int32 AddLightweightItem(TSubclassOf<AInteractableItem> ItemClass, const FTransform& Transform);
+
+	/** Turns a live item into a lightweight one, keeping its current state. The actor is destroyed. */
+	UFUNCTION(BlueprintCallable, Category = "Lightweight Items")
+	int32 AddFromActor(AInteractableItem* Item);
+
+	/** Removes a lightweight item for good (and its actor, if it's promoted right now). */
+	UFUNCTION(BlueprintCallable, Category = "Lightweight Items")
+	void RemoveLightweightItem(int32 Handle);
+
+	/** Promoted items call this when they are picked up / destroyed, so they don't come back as an instance. */
+	void NotifyItemRemoved(AInteractableItem* Item);
+
+	UFUNCTION(BlueprintCallable, Category = "Lightweight Items")
+	int32 GetNumLightweightItems() const { return NumInUse; }
+
+	UFUNCTION(BlueprintCallable, Category = "Lightweight Items")
+	int32 GetNumPromotedItems() const { return PromotedHandles.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	int32 AllocateRecord();
+	void FreeRecord(int32 Handle);
+
+	void Promote(int32 Handle);
+	void Demote(int32 Handle);
+
+	bool ResolveMesh(FLightweightItem& Record) const;
+	void ShowInstance(int32 Handle);
+	void HideInstance(FLightweightItem& Record);
+
+	/** Adds the group's pending instances to its HISM in one go, instead of one render state update per instance. */
+	void FlushPendingInstances(FLightweightItemMeshGroup& Group);
+	void FlushPendingInstances();
+	FLightweightItemMeshGroup* FindOrCreateMeshGroup(UStaticMesh* Mesh);
+
+	void GatherPlayerLocations(TArray<FVector, TInlineAllocator<4>>& OutLocations) const;
+
+	/** Lightweight items within this distance of a player are promoted to real actors. */
+	UPROPERTY(Config)
+	float PromoteRadius = 600.0f;
+
+	/** Promoted items further than this from every player go back to being instances. */
+	UPROPERTY(Config)
+	float DemoteRadius = 800.0f;
+
+	/** How often (in seconds) we look for items to promote / demote. */
+	UPROPERTY(Config)
+	float CheckInterval = 0.1f;
+
+	/** Grid cell size for the lightweight item lookup. */
+	UPROPERTY(Config)
+	float CellSize = 800.0f;
+
+	// All records; a handle is an index into this. Unused slots are recycled through FreeHandles.
+	UPROPERTY()
+	TArray<FLightweightItem> Items;
+
+	TArray<int32> FreeHandles;
+	int32 NumInUse = 0;
+
+	// Handles of items that currently have an actor
+	TArray<int32> PromotedHandles;
+
+	// Handles of dormant items whose mesh is still loading; retried every check until they can be drawn
+	TArray<int32> PendingMeshHandles;
+
+	// Only the items that are NOT promoted live in the grid, so a promote query never finds an item twice.
+	TSpatialHashGrid<int32> DormantGrid;
+
+	UPROPERTY()
+	TMap<TObjectPtr<UStaticMesh>, FLightweightItemMeshGroup> MeshGroups;
+
+	// Owner of the HISM components
+	UPROPERTY()
+	TObjectPtr<AActor> InstanceRenderer;
+
+	float TimeUntilNextCheck = 0.0f;
+};
@@ -7,7 +7,12 @@
 #include "MyGameMode.generated.h"
 
 /**
- * 
+ * Multiplayer testing on one machine, e.g.:
+ *   UnrealEditor BenjaminComp2Prog1.uproject <Map> -server -log -port=7777
+ *   UnrealEditor BenjaminComp2Prog1.uproject 127.0.0.1:7777 -game -nullrhi -nosound -log   (once per client)
+ *
+ * On a server this logs player count, server frame time and bandwidth every Froggy.Net.StatsInterval seconds
+ * (and on demand with "Froggy.Net.Stats").
  */
 UCLASS()
 class BENJAMINCOMP2PROG1_API AMyGameMode : public AGameModeBase
@@ -17,4 +22,13 @@ class BENJAMINCOMP2PROG1_API AMyGameMode : public AGameModeBase
 public:
 	AMyGameMode();
 	virtual void StartPlay() override;
+
+	// After loading a save game, Froggy comes back where it was saved instead of at a PlayerStart.
+	virtual APawn* SpawnDefaultPawnFor_Implementation(AController* NewPlayer, AActor* StartSpot) override;
+
+	/** Logs player count, game thread time, net bandwidth and how many items exist. Servers only. */
+	void LogNetStats() const;
+
+private:
+	FTimerHandle NetStatsTimerHandle;
 };
@@ -17,5 +17,11 @@ class BENJAMINCOMP2PROG1_API AProtagonistController : public APlayerController
 public:
 	static void BindInputs(AFroggyCharacter* FroggyCharacter, UEnhancedInputComponent* EnhancedInputComponent);
 	virtual void BeginPlay() override;
-	
+
+	/** Adds the mapping context and binds the Froggy's actions. Called once the Froggy's input assets have loaded. */
+	void SetupFroggyInput(AFroggyCharacter* FroggyCharacter);
+
+private:
+	// The input component we last bound to, so the same one never gets its actions bound twice.
+	TWeakObjectPtr<UEnhancedInputComponent> BoundInputComponent;
 };
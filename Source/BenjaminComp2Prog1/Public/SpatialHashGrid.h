@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A small uniform grid (spatial hash) for "what is near this point?" questions.
+ *
+ * The world is chopped into cubes of CellSize, and every element lives in the cell its location falls into.
+ * Only cells that actually contain something are stored (in a TMap), so an empty level costs nothing and a huge
+ * level costs only what is placed in it.
+ *
+ * A radius query only visits the cells the query sphere touches, so its cost depends on how crowded that local
+ * area is - not on how many elements exist in the whole level. Pick a CellSize around the size of your usual
+ * query radius; then a query touches at most 2x2x2 cells.
+ *
+ * ElementType just has to be hashable (pointers, ints, handles...). The grid never asks an element where it is,
+ * the owner passes the location in. If an element moves, call Add() again with the new location.
+ */
+template <typename ElementType>
+class TSpatialHashGrid
+{
+public:
+	explicit TSpatialHashGrid(float InCellSize = 400.0f)
+		: CellSize(FMath::Max(InCellSize, 1.0f))
+	{
+	}
+
+	/** Adds an element, or moves it if it's already in the grid. */
+	void Add(const ElementType& Element, const FVector& Location)
+	{
+		const FIntVector NewCell = ToCell(Location);
+
+		if (FIntVector* OldCell = ElementCells.Find(Element))
+		{
+			if (*OldCell == NewCell)
+			{
+				// Same cell, just refresh the stored location.
+				TArray<FCellEntry>& Entries = Cells.FindChecked(NewCell);
+				for (FCellEntry& Entry : Entries)
+				{
+					if (Entry.Element == Element)
+					{
+						Entry.Location = Location;
+						break;
+					}
+				}
+				return;
+			}
+
+			RemoveFromCell(Element, *OldCell);
+			*OldCell = NewCell;
+		}
+		else
+		{
+			ElementCells.Add(Element, NewCell);
+		}
+
+		Cells.FindOrAdd(NewCell).Add({ Element, Location });
+	}
+
+	/** Removes an element. Returns false if it was never added. */
+	bool Remove(const ElementType& Element)
+	{
+		FIntVector Cell;
+		if (!ElementCells.RemoveAndCopyValue(Element, Cell))
+		{
+			return false;
+		}
+
+		RemoveFromCell(Element, Cell);
+		return true;
+	}
+
+	bool Contains(const ElementType& Element) const { return ElementCells.Contains(Element); }
+
+	int32 Num() const { return ElementCells.Num(); }
+
+	void Empty()
+	{
+		Cells.Empty();
+		ElementCells.Empty();
+	}
+
+	/**
+	 * Calls Func(Element, Location, DistanceSquared) for every element within Radius of Center.
+	 * Don't add or remove elements from inside Func - copy what you need out first.
+	 */
+	template <typename FuncType>
+	void ForEachInRadius(const FVector& Center, float Radius, FuncType&& Func) const
+	{
+		const float RadiusSquared = Radius * Radius;
+		const FIntVector MinCell = ToCell(Center - FVector(Radius));
+		const FIntVector MaxCell = ToCell(Center + FVector(Radius));
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					const TArray<FCellEntry>* Entries = Cells.Find(FIntVector(X, Y, Z));
+					if (!Entries)
+					{
+						continue;
+					}
+
+					for (const FCellEntry& Entry : *Entries)
+					{
+						const float DistanceSquared = FVector::DistSquared(Entry.Location, Center);
+						if (DistanceSquared <= RadiusSquared)
+						{
+							Func(Entry.Element, Entry.Location, DistanceSquared);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Calls Func(Element, Location, DistanceSquared) for every element within Radius of the line segment Start -> End
+	 * (a capsule), with DistanceSquared measured to the closest point on the segment. Each element is visited once.
+	 * Handy for "what did I pass on the way here?" - a moving sphere can't skip over anything between two samples.
+	 */
+	template <typename FuncType>
+	void ForEachAlongSegment(const FVector& Start, const FVector& End, float Radius, FuncType&& Func) const
+	{
+		const float RadiusSquared = Radius * Radius;
+
+		// Walk the segment in steps of about one cell, and only look at the cells around each step. A long diagonal
+		// segment would otherwise have a huge bounding box full of cells it never gets close to.
+		const float Length = FVector::Dist(Start, End);
+		const int32 NumSteps = FMath::Max(1, FMath::CeilToInt32(Length / CellSize));
+
+		TSet<FIntVector, DefaultKeyFuncs<FIntVector>, TInlineSetAllocator<32>> VisitedCells;
+
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			const FVector StepStart = FMath::Lerp(Start, End, float(Step) / NumSteps);
+			const FVector StepEnd = FMath::Lerp(Start, End, float(Step + 1) / NumSteps);
+			const FIntVector MinCell = ToCell(StepStart.ComponentMin(StepEnd) - FVector(Radius));
+			const FIntVector MaxCell = ToCell(StepStart.ComponentMax(StepEnd) + FVector(Radius));
+
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+				{
+					for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+					{
+						const FIntVector Cell(X, Y, Z);
+
+						bool bAlreadyVisited = false;
+						VisitedCells.Add(Cell, &bAlreadyVisited);
+						if (bAlreadyVisited)
+						{
+							continue;
+						}
+
+						const TArray<FCellEntry>* Entries = Cells.Find(Cell);
+						if (!Entries)
+						{
+							continue;
+						}
+
+						for (const FCellEntry& Entry : *Entries)
+						{
+							const float DistanceSquared = FMath::PointDistToSegmentSquared(Entry.Location, Start, End);
+							if (DistanceSquared <= RadiusSquared)
+							{
+								Func(Entry.Element, Entry.Location, DistanceSquared);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/** Appends every element within Radius of Center to OutElements (in no particular order). */
+	void QueryRadius(const FVector& Center, float Radius, TArray<ElementType>& OutElements) const
+	{
+		ForEachInRadius(Center, Radius, [&OutElements](const ElementType& Element, const FVector&, float)
+		{
+			OutElements.Add(Element);
+		});
+	}
+
+	/** Appends up to MaxCount elements within Radius of Center to OutElements, closest first. */
+	void QueryNearest(const FVector& Center, float Radius, int32 MaxCount, TArray<ElementType>& OutElements) const
+	{
+		QueryNearest(Center, Radius, MaxCount, OutElements, [](const ElementType&) { return true; });
+	}
+
+	/**
+	 * Same, but only elements Filter(Element) says yes to count. The filter runs before MaxCount is applied, so
+	 * skipped elements don't take up any of the MaxCount slots.
+	 */
+	template <typename FilterType>
+	void QueryNearest(const FVector& Center, float Radius, int32 MaxCount, TArray<ElementType>& OutElements, FilterType&& Filter) const
+	{
+		if (MaxCount <= 0)
+		{
+			return;
+		}
+
+		TArray<TPair<float, ElementType>, TInlineAllocator<32>> Found;
+		ForEachInRadius(Center, Radius, [&Found, &Filter](const ElementType& Element, const FVector&, float DistanceSquared)
+		{
+			if (Filter(Element))
+			{
+				Found.Emplace(DistanceSquared, Element);
+			}
+		});
+
+		Found.Sort([](const TPair<float, ElementType>& A, const TPair<float, ElementType>& B) { return A.Key < B.Key; });
+
+		const int32 Count = FMath::Min(MaxCount, Found.Num());
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			OutElements.Add(Found[Index].Value);
+		}
+	}
+
+	float GetCellSize() const { return CellSize; }
+
+	/** Heap memory held by the grid (both maps and every cell's array), not counting sizeof(*this). */
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = Cells.GetAllocatedSize() + ElementCells.GetAllocatedSize();
+		for (const TPair<FIntVector, TArray<FCellEntry>>& Cell : Cells)
+		{
+			Size += Cell.Value.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+private:
+	struct FCellEntry
+	{
+		ElementType Element;
+		FVector Location;
+	};
+
+	FIntVector ToCell(const FVector& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt32(Location.X / CellSize),
+			FMath::FloorToInt32(Location.Y / CellSize),
+			FMath::FloorToInt32(Location.Z / CellSize));
+	}
+
+	void RemoveFromCell(const ElementType& Element, const FIntVector& Cell)
+	{
+		if (TArray<FCellEntry>* Entries = Cells.Find(Cell))
+		{
+			const int32 Index = Entries->IndexOfByPredicate([&Element](const FCellEntry& Entry) { return Entry.Element == Element; });
+			if (Index != INDEX_NONE)
+			{
+				Entries->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			}
+
+			// Drop empty cells so the map only ever holds occupied space.
+			if (Entries->IsEmpty())
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+
+	float CellSize;
+
+	// Occupied cells -> the elements (and their locations) inside them. Locations live next to the elements,
+	// so a query walks one flat array per cell instead of chasing pointers.
+	TMap<FIntVector, TArray<FCellEntry>> Cells;
+
+	// Element -> the cell it's stored in, so Remove() and moves don't have to search.
+	TMap<ElementType, FIntVector> ElementCells;
+};
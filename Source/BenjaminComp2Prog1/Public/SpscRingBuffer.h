@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * A fixed-size, lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The producer only ever writes WriteIndex, the consumer only ever writes ReadIndex, so there's no lock and no
+ * compare-and-swap - a push is a copy plus one release store. Both sides also keep a cached copy of the other
+ * side's index, so in the common case (not full / not empty) they don't even touch the other thread's cache line.
+ *
+ * Capacity is rounded up to a power of two. When the buffer is full, TryPush fails and the caller decides
+ * what to do (for telemetry: drop the event and count it).
+ *
+ * ElementType should be trivially copyable - it's copied in and out by value.
+ */
+template <typename ElementType>
+class TSpscRingBuffer
+{
+public:
+	explicit TSpscRingBuffer(uint32 InCapacity)
+	{
+		const uint32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2));
+		Slots.SetNumUninitialized(Capacity);
+		Mask = Capacity - 1;
+	}
+
+	TSpscRingBuffer(const TSpscRingBuffer&) = delete;
+	TSpscRingBuffer& operator=(const TSpscRingBuffer&) = delete;
+
+	/** Producer thread only. Returns false (and stores nothing) if the buffer is full. */
+	bool TryPush(const ElementType& Element)
+	{
+		const uint32 Write = Producer.WriteIndex.load(std::memory_order_relaxed);
+
+		if (Write - Producer.CachedReadIndex > Mask)
+		{
+			// Looks full - check where the consumer really is before giving up.
+			Producer.CachedReadIndex = Consumer.ReadIndex.load(std::memory_order_acquire);
+			if (Write - Producer.CachedReadIndex > Mask) return false;
+		}
+
+		Slots[Write & Mask] = Element;
+		Producer.WriteIndex.store(Write + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Consumer thread only. Moves everything that's in the buffer right now to the end of Out. Returns how many. */
+	int32 PopAll(TArray<ElementType>& Out)
+	{
+		const uint32 Read = Consumer.ReadIndex.load(std::memory_order_relaxed);
+		Consumer.CachedWriteIndex = Producer.WriteIndex.load(std::memory_order_acquire);
+
+		const uint32 Count = Consumer.CachedWriteIndex - Read;
+		if (Count == 0) return 0;
+
+		// At most two contiguous runs: up to the end of the slots, then from the start.
+		const uint32 First = Read & Mask;
+		const uint32 FirstRun = FMath::Min(Count, uint32(Slots.Num()) - First);
+		Out.Append(Slots.GetData() + First, FirstRun);
+		Out.Append(Slots.GetData(), Count - FirstRun);
+
+		Consumer.ReadIndex.store(Read + Count, std::memory_order_release);
+		return int32(Count);
+	}
+
+	/** Roughly how many elements are waiting. Exact only when called from one of the two threads while the other is idle. */
+	int32 Num() const
+	{
+		return int32(Producer.WriteIndex.load(std::memory_order_acquire) - Consumer.ReadIndex.load(std::memory_order_acquire));
+	}
+
+	int32 GetCapacity() const { return Slots.Num(); }
+
+private:
+	// Each side on its own cache line, so the two threads don't keep stealing the line from each other.
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FProducerSide
+	{
+		std::atomic<uint32> WriteIndex{ 0 };
+		uint32 CachedReadIndex = 0;
+	};
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FConsumerSide
+	{
+		std::atomic<uint32> ReadIndex{ 0 };
+		uint32 CachedWriteIndex = 0;
+	};
+
+	FProducerSide Producer;
+	FConsumerSide Consumer;
+
+	TArray<ElementType> Slots;
+	uint32 Mask = 0;
+};
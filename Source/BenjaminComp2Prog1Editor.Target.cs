@@ -11,5 +11,8 @@ public class BenjaminComp2Prog1EditorTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_5;
 		ExtraModuleNames.Add("BenjaminComp2Prog1");
+
+		// Items and Froggy replicate with push-model dirty marking (see AInteractableItem::GetLifetimeReplicatedProps).
+		bWithPushModel = true;
 	}
 }
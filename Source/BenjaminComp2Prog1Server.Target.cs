@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class BenjaminComp2Prog1ServerTarget : TargetRules
+{
+	public BenjaminComp2Prog1ServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V5;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_5;
+		ExtraModuleNames.Add("BenjaminComp2Prog1");
+
+		// Items and Froggy replicate with push-model dirty marking (see AInteractableItem::GetLifetimeReplicatedProps).
+		bWithPushModel = true;
+	}
+}